@@ -2,39 +2,40 @@
 
 precision mediump float;
 
-uniform sampler2D u_textures[8];
+// number of textures a batch can sample, injected by the renderer
+#ifndef TEXTURE_SLOTS
+#define TEXTURE_SLOTS 8
+#endif
+
+uniform sampler2D u_textures[TEXTURE_SLOTS];
 
 varying vec2 v_textureCoord;
 varying vec4 v_color;
 varying float v_textureID;
 
+vec4 SampleTexture() {
+#if TEXTURE_SLOTS == 1
+    return texture2D(u_textures[0], v_textureCoord);
+#else
+    int id = int(v_textureID);
+
+    if (id == 0) return texture2D(u_textures[0], v_textureCoord);
+    if (id == 1) return texture2D(u_textures[1], v_textureCoord);
+#if TEXTURE_SLOTS > 2
+    if (id == 2) return texture2D(u_textures[2], v_textureCoord);
+    if (id == 3) return texture2D(u_textures[3], v_textureCoord);
+#endif
+#if TEXTURE_SLOTS > 4
+    if (id == 4) return texture2D(u_textures[4], v_textureCoord);
+    if (id == 5) return texture2D(u_textures[5], v_textureCoord);
+    if (id == 6) return texture2D(u_textures[6], v_textureCoord);
+    if (id == 7) return texture2D(u_textures[7], v_textureCoord);
+#endif
+
+    return vec4(1.0);
+#endif
+}
+
 void main() {
-    vec4 o_color = v_color;
-
-    if (int(v_textureID) == 0) {
-        o_color = v_color * texture2D(u_textures[0], v_textureCoord);
-    }
-    else if (int(v_textureID) == 1) {
-        o_color = v_color * texture2D(u_textures[1], v_textureCoord);
-    }
-    else if (int(v_textureID) == 2) {
-        o_color = v_color * texture2D(u_textures[2], v_textureCoord);
-    }
-    else if (int(v_textureID) == 3) {
-        o_color = v_color * texture2D(u_textures[3], v_textureCoord);
-    }
-    else if (int(v_textureID) == 4) {
-        o_color = v_color * texture2D(u_textures[4], v_textureCoord);
-    }
-    else if (int(v_textureID) == 5) {
-        o_color = v_color * texture2D(u_textures[5], v_textureCoord);
-    }
-    else if (int(v_textureID) == 6) {
-        o_color = v_color * texture2D(u_textures[6], v_textureCoord);
-    }
-    else if (int(v_textureID) == 7) {
-        o_color = v_color * texture2D(u_textures[7], v_textureCoord);
-    }
-
-    gl_FragColor = o_color;
-}
\ No newline at end of file
+    gl_FragColor = v_color * SampleTexture();
+}
@@ -1,65 +1,106 @@
 #include "core/Application.h"
+#include "core/renderer/DebugDraw.h"
 #include "core/renderer/Renderer2D.h"
 #include "Game.h"
 
-struct Rect {
-    Vec2 position;
-    Vec2 size;
-};
+#include <stdio.h>
 
-static bool PointInRect(const Vec2& point, const Rect& rect) {
-    return (point.x >= rect.position.x) && 
-           (point.x <= rect.position.x + rect.size.x) && 
-           (point.y >= rect.position.y) && 
-           (point.y <= rect.position.y + rect.size.y);
-}
+#include <SDL.h>
 
-static bool RectInRect(const Rect& a, const Rect& b) {
-    return (a.position.x + a.size.x >= b.position.x) &&
-           (a.position.x <= b.position.x + b.size.x) && 
-           (a.position.y + a.size.y >= b.position.y) && 
-           (a.position.y <= b.position.y + b.size.y);
-}
+EntityID EntityAtPosition(World& world, const Vec2& position) {
+    ArenaList<EntityData*> entities(Memory::FrameArena(), world.EntityCount());
+    world.QueryRect({ position, {} }, EntityFlags::TRANSFORM, entities);
 
-static Rect GetEntityRect(World& world, EntityID id) {
-    EntityData* entity = world.GetEntityData(id);
+    for (int i = 0; i < entities.Size(); i++) {
+        const EntityData* entity = entities[i];
 
-    if (!entity) {
-        return {};
+        // the grid answers with bounds, the sprite itself may be turned
+        if (OrientedBox::FromEntity(*entity).Contains(position)) {
+            return entity->id;
+        }
     }
 
-    return {
-        .position = {
-            entity->transform.position.x - (entity->transform.size.x / 2.0f),
-            entity->transform.position.y - (entity->transform.size.y / 2.0f),
-        },
+    return 0;
+}
 
-        .size = {
-            entity->transform.size.x,
-            entity->transform.size.y,
-        },
-    };
+void RegisterActions() {
+    GameActions& actions = m_gameState.actions;
+
+    actions.panLeft   = Input::AddAction("pan_left");
+    actions.panRight  = Input::AddAction("pan_right");
+    actions.panUp     = Input::AddAction("pan_up");
+    actions.panDown   = Input::AddAction("pan_down");
+    actions.select    = Input::AddAction("select");
+    actions.destroy   = Input::AddAction("destroy");
+    actions.spawnWave = Input::AddAction("spawn_wave");
+
+    actions.saveSnapshot = Input::AddAction("save_snapshot");
+    actions.loadSnapshot = Input::AddAction("load_snapshot");
+
+    Input::Bind(actions.panLeft, INPUT_KEYBOARD, SDL_SCANCODE_A);
+    Input::Bind(actions.panLeft, INPUT_KEYBOARD, SDL_SCANCODE_LEFT);
+    Input::Bind(actions.panRight, INPUT_KEYBOARD, SDL_SCANCODE_D);
+    Input::Bind(actions.panRight, INPUT_KEYBOARD, SDL_SCANCODE_RIGHT);
+    Input::Bind(actions.panUp, INPUT_KEYBOARD, SDL_SCANCODE_W);
+    Input::Bind(actions.panUp, INPUT_KEYBOARD, SDL_SCANCODE_UP);
+    Input::Bind(actions.panDown, INPUT_KEYBOARD, SDL_SCANCODE_S);
+    Input::Bind(actions.panDown, INPUT_KEYBOARD, SDL_SCANCODE_DOWN);
+
+    Input::Bind(actions.select, INPUT_MOUSE, SDL_BUTTON_LEFT);
+    Input::Bind(actions.destroy, INPUT_KEYBOARD, SDL_SCANCODE_DELETE);
+    Input::Bind(actions.spawnWave, INPUT_KEYBOARD, SDL_SCANCODE_SPACE);
+
+    Input::Bind(actions.saveSnapshot, INPUT_KEYBOARD, SDL_SCANCODE_F5);
+    Input::Bind(actions.loadSnapshot, INPUT_KEYBOARD, SDL_SCANCODE_F9);
 }
 
-EntityID EntityAtPosition(World& world, const Vec2& position) {
-    auto entities = world.EntitiesWithFlags(EntityFlags::TRANSFORM);
+void SpawnPlanes(usize count) {
+    World& world = m_gameState.world;
 
-    for (int i = 0; i < entities.Size(); i++) {
-        EntityID id = entities[i];
-        const Transform& transform = world.GetEntityData(id)->transform;
+    usize room = MAX_ENTITY_COUNT - world.EntityCount();
+    count = (count < room) ? count : room;
 
-        if (PointInRect(position, GetEntityRect(world, id))) {
-            return id;
-        }
+    Vec2 windowSize = Application::WindowSize();
+
+    EntityData* planes = world.CreateEntities(m_gameState.planePrefab, count);
+    RandomStream& random = m_gameState.random;
+
+    for (usize i = 0; i < count; i++) {
+        Transform& transform = planes[i].transform;
+        Motion& motion       = planes[i].motion;
+
+        transform.position.x = Random::Range(random, 0.0f, windowSize.x);
+        transform.position.y = Random::Range(random, 0.0f, windowSize.y);
+
+        f32 angle = Random::Range(random, 0.0f, 2.0f * PI);
+
+        motion.velocity.x = m_gameState.sim.cruiseSpeed * cosf(angle);
+        motion.velocity.y = m_gameState.sim.cruiseSpeed * sinf(angle);
     }
+}
 
-    return 0;
+void UpdateCamera(f32 deltaTime) {
+    static constexpr f32 CAMERA_SPEED = 400.0f;
+
+    Camera2D& camera = m_gameState.camera;
+    camera.viewportSize = Application::WindowSize();
+
+    Vec2 direction = {};
+
+    const GameActions& actions = m_gameState.actions;
+
+    if (Input::ActionDown(actions.panLeft))  direction.x -= 1;
+    if (Input::ActionDown(actions.panRight)) direction.x += 1;
+    if (Input::ActionDown(actions.panUp))    direction.y -= 1;
+    if (Input::ActionDown(actions.panDown))  direction.y += 1;
+
+    camera.position += direction.Normalized() * (CAMERA_SPEED * deltaTime / camera.zoom);
 }
 
 void UpdateInputState() {
-    Vec2 mousePos = Application::MousePos();
+    Vec2 mousePos = m_gameState.camera.ScreenToWorld(Application::MousePos());
 
-    if (Application::MousePressed(1)) {
+    if (Input::ActionPressed(m_gameState.actions.select)) {
         m_gameState.selectedEntity = EntityAtPosition(m_gameState.world, mousePos);
         
         EntityData* entity = m_gameState.world.GetEntityData(m_gameState.selectedEntity);
@@ -71,17 +112,17 @@ void UpdateInputState() {
         entity->path.Clear();
         m_gameState.canDrawPath = true;
     }
-    else if (Application::MouseReleased(1)) {
+    else if (Input::ActionReleased(m_gameState.actions.select)) {
         m_gameState.canDrawPath = false;
     }
 }
 
 void PlacePathPoint() {
-    if (!m_gameState.canDrawPath || m_gameState.drawnPath.Full()) {
+    if (!m_gameState.canDrawPath) {
         return;
     }
 
-    Vec2 mousePos = Application::MousePos();
+    Vec2 mousePos = m_gameState.camera.ScreenToWorld(Application::MousePos());
 
     int tileX = mousePos.x / m_gameState.tileSize;
     int tileY = mousePos.y / m_gameState.tileSize;
@@ -92,7 +133,7 @@ void PlacePathPoint() {
 
     EntityData* entity = m_gameState.world.GetEntityData(m_gameState.selectedEntity);
 
-    if (!entity) {
+    if (!entity || entity->path.points.Full()) {
         return;
     }
 
@@ -105,24 +146,37 @@ void PlacePathPoint() {
     m_gameState.lastTileY = tileY;
 }
 
-void DebugDrawPath(EntityID entityID) {
-    EntityData* entity = m_gameState.world.GetEntityData(entityID);
+void DebugDrawPath(const EntityData& entity) {
+    const Path& path = entity.path;
 
-    if (!entity) {
+    if (path.Remaining() < 2) {
         return;
     }
 
-    if (entity->path.Size() < 2) {
-        return;
-    }
+    f32 markerSize = (f32)m_gameState.tileSize / 4;
+    DebugDraw::Polyline(DEBUG_PATHS, entity.id, path.version, path.points.Data(), path.points.Size(), path.next, markerSize, RED, WHITE);
+}
 
-    // draw path lines
-    for (int i = 0; i < entity->path.Size() - 1; i++) {
-        Renderer2D::DrawLine(entity->path[i], entity->path[i + 1], RED);
-    }
+// centred above position, which is where the entity is drawn this frame
+void DrawEntityLabel(const EntityData& entity, const Vec2& position) {
+    char text[32];
+    snprintf(text, sizeof(text), "%.0f px/s", entity.motion.velocity.Length());
 
-    // draw path points
-    for (int i = 0; i < entity->path.Size(); i++) {
-        Renderer2D::DrawRect(entity->path[i], { (f32) m_gameState.tileSize / 4, (f32)m_gameState.tileSize / 4 }, WHITE);
-    }
+    Vec2 size = Renderer2D::MeasureText(m_gameState.font, text);
+
+    Vec2 textPosition = {
+        position.x - (size.x / 2.0f),
+        position.y - (entity.transform.size.y / 2.0f) - size.y,
+    };
+
+    Renderer2D::DrawText(m_gameState.font, text, textPosition, WHITE);
+}
+
+void DrawHUD(const TimeStep& timeStep) {
+    char text[64];
+    snprintf(text, sizeof(text), "FrameTime: %.2f ms", timeStep.DeltaTimeMS());
+
+    Renderer2D::Begin();
+    Renderer2D::DrawText(m_gameState.font, text, { 8.0f, 8.0f }, WHITE);
+    Renderer2D::End();
 }
\ No newline at end of file
@@ -1,15 +1,37 @@
 #ifndef GAME_H
 #define GAME_H
 
+#include "core/Application.h"
+#include "core/Input.h"
+#include "core/Random.h"
+#include "core/renderer/Camera.h"
+#include "core/renderer/Font.h"
+#include "core/renderer/Tilemap.h"
 #include "entity/Entity.h"
+#include "entity/Snapshot.h"
+#include "entity/StateStream.h"
 #include "entity/World.h"
 #include "List.h"
+#include "Simulation.h"
+
+struct GameActions {
+    ActionID panLeft;
+    ActionID panRight;
+    ActionID panUp;
+    ActionID panDown;
+
+    ActionID select;
+    ActionID destroy;
+    ActionID spawnWave;
+
+    ActionID saveSnapshot;
+    ActionID loadSnapshot;
+};
 
 struct GameState {
     EntityID selectedEntity;
     
     bool canDrawPath;
-    List<Vec2, MAX_PATH_SIZE> drawnPath;
 
     Vec2 lastMousePos;
     
@@ -18,14 +40,44 @@ struct GameState {
 
     int tileSize = 16;
 
+    // the world context, refreshed from the camera and selection every frame
+    SimSettings sim;
+
+    GameActions actions;
+    Prefab planePrefab;
+    RandomStream random;
+
+    Camera2D camera;
+    Tilemap background;
+    Font font;
+
     World world;
+
+    // quick saves are written over several frames
+    SnapshotWriter snapshotWriter;
+
+    // every tick, when recording with --stream
+    StateStreamWriter stream;
 };
 
 inline GameState m_gameState;
 
+inline constexpr usize WAVE_SIZE = 500;
+
+inline constexpr const char* QUICKSAVE_FILE = "quicksave.snapshot";
+
+// bytes of a snapshot written per frame, a full world is done within a few frames
+inline constexpr usize SNAPSHOT_SLICE_SIZE = 4 * 1024 * 1024;
+
+void RegisterActions();
+void SpawnPlanes(usize count);
+
+void UpdateCamera(f32 deltaTime);
 void UpdateInputState();
 void PlacePathPoint();
 
-void DebugDrawPath(EntityID entityID);
+void DebugDrawPath(const EntityData& entity);
+void DrawEntityLabel(const EntityData& entity, const Vec2& position);
+void DrawHUD(const TimeStep& timeStep);
 
 #endif
\ No newline at end of file
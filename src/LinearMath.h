@@ -5,6 +5,11 @@
 
 #include <math.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LINEAR_MATH_SSE2 1
+#include <emmintrin.h>
+#endif
+
 #define PI 3.14159265359f
 
 #define RAD_TO_DEG (180.0f / PI)
@@ -94,9 +99,7 @@ struct Vec4 {
         return sqrtf((x * x) + (y * y) + (z * z) + (w * w));
     }
 
-    f32 Dot(const Vec4& v) const {
-        return (x * v.x) + (y * v.y) + (z * v.z) + (w * v.w);
-    }
+    f32 Dot(const Vec4& v) const;
 
     Vec4 Normalized() const {
         f32 len = Length();
@@ -109,29 +112,74 @@ struct Vec4 {
     }
 };
 
+/* VEC4 SIMD HELPERS */
+
+//NOTE: Vec4 is not over-aligned on purpose, it is embedded in vertex
+//      structs whose layout has to match the attribute stride
+#ifdef LINEAR_MATH_SSE2
+inline __m128 LoadVec4(const Vec4& v) {
+    return _mm_loadu_ps(&v.x);
+}
+
+inline Vec4 StoreVec4(__m128 v) {
+    Vec4 result;
+    _mm_storeu_ps(&result.x, v);
+    return result;
+}
+
+// horizontal sum of all four lanes, broadcast to every lane
+inline __m128 HorizontalSum(__m128 v) {
+    __m128 shuf = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sums = _mm_add_ps(v, shuf);
+    shuf = _mm_shuffle_ps(sums, sums, _MM_SHUFFLE(1, 0, 3, 2));
+    return _mm_add_ps(sums, shuf);
+}
+#endif
+
+inline f32 Vec4::Dot(const Vec4& v) const {
+#ifdef LINEAR_MATH_SSE2
+    return _mm_cvtss_f32(HorizontalSum(_mm_mul_ps(LoadVec4(*this), LoadVec4(v))));
+#else
+    return (x * v.x) + (y * v.y) + (z * v.z) + (w * v.w);
+#endif
+}
+
 /* VEC4 OPERATORS */
 
 inline bool operator==(const Vec4& a, const Vec4& b) {
     return (a.x == b.x) && (a.y == b.y) && (a.z == b.z) && (a.w == b.w);
 }
 
+inline Vec4 operator+(const Vec4& a, const Vec4& b) {
+#ifdef LINEAR_MATH_SSE2
+    return StoreVec4(_mm_add_ps(LoadVec4(a), LoadVec4(b)));
+#else
+    return { a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w };
+#endif
+}
+
 inline Vec4& operator+=(Vec4& a, const Vec4& b) {
-    a.x += b.x;
-    a.y += b.y;
-    a.z += b.z;
-    a.w += b.w;
+    a = a + b;
     return a;
 }
 
 inline Vec4 operator-(const Vec4& a, const Vec4& b) {
+#ifdef LINEAR_MATH_SSE2
+    return StoreVec4(_mm_sub_ps(LoadVec4(a), LoadVec4(b)));
+#else
     return { a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w };
+#endif
 }
 
 inline Vec4 operator*(const Vec4& v, float s) {
+#ifdef LINEAR_MATH_SSE2
+    return StoreVec4(_mm_mul_ps(LoadVec4(v), _mm_set1_ps(s)));
+#else
     return { v.x * s, v.y * s, v.z * s, v.w * s };
+#endif
 }
 
-struct Mat4 {
+struct alignas(16) Mat4 {
     Vec4 r0;
     Vec4 r1;
     Vec4 r2;
@@ -149,29 +197,61 @@ struct Mat4 {
 
 /* MAT4 OPERATORS */
 
-inline Vec2 operator*(const Mat4& m, const Vec2& v) {
-    Vec4 nv = { v.x, v.y, 0.0f, 1.0f };
-
-    Vec4 tv = {
-        .x = m.r0.Dot(nv),
-        .y = m.r1.Dot(nv),
-        .z = m.r2.Dot(nv),
-        .w = m.r3.Dot(nv),
-    };
-
-    return { tv.x, tv.y };
-}
-
 inline Vec4 operator*(const Mat4& m, const Vec4& v) {
+#ifdef LINEAR_MATH_SSE2
+    // transpose into columns so the product is four broadcast multiply-adds
+    __m128 c0 = LoadVec4(m.r0);
+    __m128 c1 = LoadVec4(m.r1);
+    __m128 c2 = LoadVec4(m.r2);
+    __m128 c3 = LoadVec4(m.r3);
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+    __m128 result = _mm_mul_ps(c0, _mm_set1_ps(v.x));
+    result = _mm_add_ps(result, _mm_mul_ps(c1, _mm_set1_ps(v.y)));
+    result = _mm_add_ps(result, _mm_mul_ps(c2, _mm_set1_ps(v.z)));
+    result = _mm_add_ps(result, _mm_mul_ps(c3, _mm_set1_ps(v.w)));
+
+    return StoreVec4(result);
+#else
     return {
         .x = m.r0.Dot(v),
         .y = m.r1.Dot(v),
         .z = m.r2.Dot(v),
         .w = m.r3.Dot(v),
     };
+#endif
+}
+
+inline Vec2 operator*(const Mat4& m, const Vec2& v) {
+    Vec4 tv = m * Vec4{ v.x, v.y, 0.0f, 1.0f };
+    return { tv.x, tv.y };
+}
+
+#ifdef LINEAR_MATH_SSE2
+// one row of a * b, i.e. a linear combination of the rows of b
+inline __m128 MulMat4Row(const Vec4& a, __m128 b0, __m128 b1, __m128 b2, __m128 b3) {
+    __m128 row = _mm_mul_ps(_mm_set1_ps(a.x), b0);
+    row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a.y), b1));
+    row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a.z), b2));
+    row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a.w), b3));
+    return row;
 }
+#endif
 
 inline Mat4 operator*(const Mat4& a, const Mat4& b) {
+#ifdef LINEAR_MATH_SSE2
+    __m128 b0 = LoadVec4(b.r0);
+    __m128 b1 = LoadVec4(b.r1);
+    __m128 b2 = LoadVec4(b.r2);
+    __m128 b3 = LoadVec4(b.r3);
+
+    return {
+        .r0 = StoreVec4(MulMat4Row(a.r0, b0, b1, b2, b3)),
+        .r1 = StoreVec4(MulMat4Row(a.r1, b0, b1, b2, b3)),
+        .r2 = StoreVec4(MulMat4Row(a.r2, b0, b1, b2, b3)),
+        .r3 = StoreVec4(MulMat4Row(a.r3, b0, b1, b2, b3)),
+    };
+#else
     Mat4 bT = b.Transposed();
 
     return {
@@ -180,35 +260,176 @@ inline Mat4 operator*(const Mat4& a, const Mat4& b) {
         .r2 = { a.r2.Dot(bT.r0), a.r2.Dot(bT.r1), a.r2.Dot(bT.r2), a.r2.Dot(bT.r3) },
         .r3 = { a.r3.Dot(bT.r0), a.r3.Dot(bT.r1), a.r3.Dot(bT.r2), a.r3.Dot(bT.r3) },
     };
+#endif
 }
 
-struct Transform {
+// 2D affine transform, the top two rows of a 3x3 matrix whose last row is
+// always [0 0 1]. this is all a sprite needs, so there is no point paying
+// for a full Mat4 per quad
+struct Mat3x2 {
+    f32 m00 = 1.0f;
+    f32 m01 = 0.0f;
+    f32 m02 = 0.0f;
+
+    f32 m10 = 0.0f;
+    f32 m11 = 1.0f;
+    f32 m12 = 0.0f;
+
+    Mat4 ToMat4() const {
+        return {
+            .r0 = { m00,  m01,  0.0f, m02 },
+            .r1 = { m10,  m11,  0.0f, m12 },
+            .r2 = { 0.0f, 0.0f, 1.0f, 0.0f },
+            .r3 = { 0.0f, 0.0f, 0.0f, 1.0f },
+        };
+    }
+};
+
+/* MAT3X2 OPERATORS */
+
+inline Vec2 operator*(const Mat3x2& m, const Vec2& v) {
+    return {
+        (m.m00 * v.x) + (m.m01 * v.y) + m.m02,
+        (m.m10 * v.x) + (m.m11 * v.y) + m.m12,
+    };
+}
+
+inline Mat3x2 operator*(const Mat3x2& a, const Mat3x2& b) {
+    return {
+        .m00 = (a.m00 * b.m00) + (a.m01 * b.m10),
+        .m01 = (a.m00 * b.m01) + (a.m01 * b.m11),
+        .m02 = (a.m00 * b.m02) + (a.m01 * b.m12) + a.m02,
+
+        .m10 = (a.m10 * b.m00) + (a.m11 * b.m10),
+        .m11 = (a.m10 * b.m01) + (a.m11 * b.m11),
+        .m12 = (a.m10 * b.m02) + (a.m11 * b.m12) + a.m12,
+    };
+}
+
+// scale * rotation followed by a translation, same convention as Transform::Matrix()
+inline Mat3x2 AffineMatrix(const Vec2& position, const Vec2& size, f32 sinRotation, f32 cosRotation) {
+    return {
+        .m00 = size.x * cosRotation,
+        .m01 = size.x * -sinRotation,
+        .m02 = position.x,
+
+        .m10 = size.y * sinRotation,
+        .m11 = size.y * cosRotation,
+        .m12 = position.y,
+    };
+}
+
+inline Mat3x2 RotationMatrix(f32 rotation) {
+    return AffineMatrix({}, { 1.0f, 1.0f }, sinf(rotation), cosf(rotation));
+}
+
+/* BATCH TRANSFORMS */
+
+// transforms count points by m, in and out may alias
+inline void TransformPoints(const Mat3x2& m, const Vec2* in, Vec2* out, usize count) {
+    usize i = 0;
+
+#ifdef LINEAR_MATH_SSE2
+    // two points per register: [x0 y0 x1 y1]
+    __m128 col0 = _mm_setr_ps(m.m00, m.m10, m.m00, m.m10);
+    __m128 col1 = _mm_setr_ps(m.m01, m.m11, m.m01, m.m11);
+    __m128 col2 = _mm_setr_ps(m.m02, m.m12, m.m02, m.m12);
+
+    for (; i + 2 <= count; i += 2) {
+        __m128 points = _mm_loadu_ps(&in[i].x);
+
+        __m128 xx = _mm_shuffle_ps(points, points, _MM_SHUFFLE(2, 2, 0, 0));
+        __m128 yy = _mm_shuffle_ps(points, points, _MM_SHUFFLE(3, 3, 1, 1));
+
+        __m128 result = _mm_add_ps(_mm_mul_ps(xx, col0), _mm_add_ps(_mm_mul_ps(yy, col1), col2));
+        _mm_storeu_ps(&out[i].x, result);
+    }
+#endif
+
+    for (; i < count; i++) {
+        out[i] = m * in[i];
+    }
+}
+
+// transforms count points by m, in and out may alias
+inline void TransformPoints(const Mat4& m, const Vec4* in, Vec4* out, usize count) {
+#ifdef LINEAR_MATH_SSE2
+    __m128 c0 = LoadVec4(m.r0);
+    __m128 c1 = LoadVec4(m.r1);
+    __m128 c2 = LoadVec4(m.r2);
+    __m128 c3 = LoadVec4(m.r3);
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+    for (usize i = 0; i < count; i++) {
+        __m128 result = _mm_mul_ps(c0, _mm_set1_ps(in[i].x));
+        result = _mm_add_ps(result, _mm_mul_ps(c1, _mm_set1_ps(in[i].y)));
+        result = _mm_add_ps(result, _mm_mul_ps(c2, _mm_set1_ps(in[i].z)));
+        result = _mm_add_ps(result, _mm_mul_ps(c3, _mm_set1_ps(in[i].w)));
+
+        _mm_storeu_ps(&out[i].x, result);
+    }
+#else
+    for (usize i = 0; i < count; i++) {
+        out[i] = m * in[i];
+    }
+#endif
+}
+
+// corners of the unit quad centered on the origin, in the order
+// bottom left, bottom right, top right, top left
+inline constexpr Vec2 UNIT_QUAD_CORNERS[4] = {
+    { -0.5f, -0.5f },
+    {  0.5f, -0.5f },
+    {  0.5f,  0.5f },
+    { -0.5f,  0.5f },
+};
+
+inline void TransformQuad(const Mat3x2& m, Vec2 out[4]) {
+    TransformPoints(m, UNIT_QUAD_CORNERS, out, 4);
+}
+
+// axis aligned rectangle, position is the top left corner
+struct Rect {
     Vec2 position;
     Vec2 size;
-    f32 rotation;
-
-    Mat4 Matrix() const {
-        f32 tx = position.x;
-        f32 ty = position.y;
 
-        f32 sx = size.x;
-        f32 sy = size.y;
+    bool Overlaps(const Rect& r) const {
+        return (position.x + size.x >= r.position.x) &&
+               (position.x <= r.position.x + r.size.x) &&
+               (position.y + size.y >= r.position.y) &&
+               (position.y <= r.position.y + r.size.y);
+    }
 
-        Mat4 rotMatrix = {
-            .r0 = { cosf(rotation), -sinf(rotation), 0.0f, 0.0f },
-            .r1 = { sinf(rotation),  cosf(rotation), 0.0f, 0.0f },
-            .r2 = { 0.0f,            0.0f,           1.0f, 0.0f },
-            .r3 = { 0.0f,            0.0f,           0.0f, 1.0f },
+    Rect Expanded(f32 amount) const {
+        return {
+            .position = { position.x - amount, position.y - amount },
+            .size     = { size.x + (amount * 2.0f), size.y + (amount * 2.0f) },
         };
+    }
+};
 
-        Mat4 transformMatrix = {
-            .r0 = { sx,   0.0f, 0.0f, tx },
-            .r1 = { 0.0f, sy,   0.0f, ty },
-            .r2 = { 0.0f, 0.0f, 1.0f, 0.0f },
-            .r3 = { 0.0f, 0.0f, 0.0f, 1.0f },
-        };
+// axis aligned bounds of the unit quad transformed by m
+inline Rect BoundingRect(const Mat3x2& m) {
+    f32 halfWidth  = 0.5f * (fabsf(m.m00) + fabsf(m.m01));
+    f32 halfHeight = 0.5f * (fabsf(m.m10) + fabsf(m.m11));
 
-        return transformMatrix * rotMatrix;
+    return {
+        .position = { m.m02 - halfWidth, m.m12 - halfHeight },
+        .size     = { halfWidth * 2.0f, halfHeight * 2.0f },
+    };
+}
+
+struct Transform {
+    Vec2 position;
+    Vec2 size;
+    f32 rotation;
+
+    Mat3x2 Matrix2D() const {
+        return AffineMatrix(position, size, sinf(rotation), cosf(rotation));
+    }
+
+    Mat4 Matrix() const {
+        return Matrix2D().ToMat4();
     }
 };
 
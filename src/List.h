@@ -2,12 +2,29 @@
 #define LIST_H
 
 #include "Basic.h"
+#include "core/Memory.h"
 
 #include <string.h>
 
 template<typename T, size_t Cap>
 class List {
 public:
+    List() = default;
+
+    List(const List& other) {
+        *this = other;
+    }
+
+    // only the live items are copied, not the whole capacity
+    List& operator=(const List& other) {
+        for (size_t i = 0; i < other.m_size; i++) {
+            m_data[i] = other.m_data[i];
+        }
+
+        m_size = other.m_size;
+        return *this;
+    }
+
     void Push(const T& item) {
         ASSERT(m_size < Cap);
         m_data[m_size] = item;
@@ -25,7 +42,7 @@ public:
         void* dest = &m_data[index];
         void* src = &m_data[index + 1];
 
-        memmove(dest, src, sizeof(T) * (m_size - index));
+        memmove(dest, src, sizeof(T) * (m_size - index - 1));
 
         m_size -= 1;
     }
@@ -40,6 +57,17 @@ public:
         m_size = 0;
     }
 
+    void Truncate(size_t size) {
+        ASSERT(size <= m_size);
+        m_size = size;
+    }
+
+    // appends count items without writing them, the caller initialises them
+    void Grow(size_t count) {
+        ASSERT(m_size + count <= Cap);
+        m_size += count;
+    }
+
     size_t Size() const {
         return m_size;
     }
@@ -56,6 +84,10 @@ public:
         return m_size == 0;
     }
 
+    T* Data() {
+        return m_data;
+    }
+
     const T* Data() const {
         return m_data;
     }
@@ -74,4 +106,90 @@ private:
     T m_data[Cap] = {};
 };
 
+// List with a capacity picked at runtime, the items come from an Arena
+template<typename T>
+class ArenaList {
+public:
+    ArenaList() = default;
+
+    ArenaList(Arena& arena, size_t capacity)
+        : m_data(arena.Alloc<T>(capacity)), m_capacity(capacity) {}
+
+    void Push(const T& item) {
+        ASSERT(m_size < m_capacity);
+        m_data[m_size] = item;
+        m_size += 1;
+    }
+
+    void Remove(size_t index) {
+        ASSERT(index >= 0 && index < m_size);
+
+        if (index == m_size - 1) {
+            m_size -= 1;
+            return;
+        }
+
+        void* dest = &m_data[index];
+        void* src = &m_data[index + 1];
+
+        memmove(dest, src, sizeof(T) * (m_size - index - 1));
+
+        m_size -= 1;
+    }
+
+    void QuickRemove(size_t index) {
+        ASSERT(index >= 0 && index < m_size);
+        m_data[index] = m_data[m_size - 1];
+        m_size -= 1;
+    }
+
+    void Clear() {
+        m_size = 0;
+    }
+
+    // appends count items without writing them, the caller initialises them
+    void Grow(size_t count) {
+        ASSERT(m_size + count <= m_capacity);
+        m_size += count;
+    }
+
+    size_t Size() const {
+        return m_size;
+    }
+
+    size_t Capacity() const {
+        return m_capacity;
+    }
+
+    bool Full() const {
+        return m_size == m_capacity;
+    }
+
+    bool Empty() const {
+        return m_size == 0;
+    }
+
+    T* Data() {
+        return m_data;
+    }
+
+    const T* Data() const {
+        return m_data;
+    }
+
+    T& operator[](size_t index) {
+        ASSERT(index >= 0 && index < m_size);
+        return m_data[index];
+    }
+
+    const T& operator[](size_t index) const {
+        ASSERT(index >= 0 && index < m_size);
+        return m_data[index];
+    }
+private:
+    T* m_data          = NULL;
+    size_t m_size      = 0;
+    size_t m_capacity  = 0;
+};
+
 #endif
@@ -2,6 +2,7 @@
 #define MAP_H
 
 #include "Basic.h"
+#include "core/Memory.h"
 
 #include <memory>
 
@@ -13,130 +14,174 @@ struct MapEntry {
     bool empty = true;
 };
 
-template<typename K, typename V, size_t Capacity>
-class Map {
+// open addressing with linear probing over the entries provided by Storage
+// (Map or ArenaMap). removal shifts the rest of the probe run back instead of
+// leaving holes, so a lookup can stop at the first empty entry
+template<typename K, typename V, typename Storage>
+class MapBase {
 public:
     void Add(const K& key, const V& value) {
         ASSERT(!Full());
-        size_t index = std::hash<K>{}(key) % Capacity;
+        size_t index = Home(key);
 
-        while (!m_data[index].empty) {
-            index = (index + 1) % Capacity;
+        while (!Entries()[index].empty) {
+            index = (index + 1) % Capacity();
         }
 
-        m_data[index] = { key, value, false };
+        Entries()[index] = { key, value, false };
         m_size += 1;
     }
 
     void Remove(const K& key) {
-        ASSERT(Contains(key));
+        i64 found = Find(key);
+        ASSERT(found != -1);
 
-        size_t index = std::hash<K>{}(key) % Capacity;
+        MapEntry<K, V>* entries = Entries();
+        size_t capacity = Capacity();
+
+        size_t hole = (size_t)found;
+        size_t index = hole;
 
         while (true) {
-            MapEntry<K, V>& entry = m_data[index];
+            index = (index + 1) % capacity;
 
-            if (entry.empty) {
-                index = (index + 1) % Capacity;
-                continue;
+            if (entries[index].empty) {
+                break;
             }
 
-            if (key == entry.first) {
-                entry.empty = true;
-                m_size -= 1;
+            size_t home = Home(entries[index].first);
 
-                return;
-            }
+            // the entry can fill the hole if its home is not cyclically inside (hole, index]
+            bool canMove = (hole <= index) ? (home <= hole || home > index)
+                                           : (home <= hole && home > index);
 
-            index = (index + 1) % Capacity;
+            if (canMove) {
+                entries[hole] = entries[index];
+                hole = index;
+            }
         }
+
+        entries[hole].empty = true;
+        m_size -= 1;
     }
 
     V& Get(const K& key) {
-        ASSERT(Contains(key));
+        i64 found = Find(key);
+        ASSERT(found != -1);
 
-        size_t index = std::hash<K>{}(key) % Capacity;
-
-        while (true) {
-            MapEntry<K, V>& entry = m_data[index];
+        return Entries()[found].second;
+    }
 
-            if (entry.empty) {
-                index = (index + 1) % Capacity;
-                continue;
-            }
+    void Set(const K& key, const V& value) {
+        i64 found = Find(key);
+        ASSERT(found != -1);
 
-            if (key == entry.first) {
-                return entry.second;
-            }
+        Entries()[found].second = value;
+    }
 
-            index = (index + 1) % Capacity;
-        }
+    bool Contains(const K& key) const {
+        return Find(key) != -1;
+    }
 
-        ASSERT(false);
+    size_t Size() const {
+        return m_size;
     }
 
-    void Set(const K& key, const V& value) {
-        ASSERT(Contains(key));
+    bool Full() const {
+        return m_size == Capacity();
+    }
 
-        size_t index = std::hash<K>{}(key) % Capacity;
+    bool Empty() const {
+        return m_size == 0;
+    }
 
-        while (true) {
-            MapEntry<K, V>& entry = m_data[index];
+protected:
+    MapEntry<K, V>* Entries() {
+        return static_cast<Storage*>(this)->EntryData();
+    }
 
-            if (entry.empty) {
-                index = (index + 1) % Capacity;
-                continue;
-            }
+    const MapEntry<K, V>* Entries() const {
+        return static_cast<const Storage*>(this)->EntryData();
+    }
 
-            if (key == entry.first) {
-                entry.second = value;
-                return;
-            }
+    size_t Capacity() const {
+        return static_cast<const Storage*>(this)->EntryCapacity();
+    }
 
-            index = (index + 1) % Capacity;
-        }
+    size_t Home(const K& key) const {
+        return std::hash<K>{}(key) % Capacity();
     }
 
-    bool Contains(const K& key) const {
+    i64 Find(const K& key) const {
         if (Empty()) {
-            return false;
+            return -1;
         }
 
-        size_t index = std::hash<K>{}(key) % Capacity;
-        size_t currentIndex = index;
+        const MapEntry<K, V>* entries = Entries();
+        size_t capacity = Capacity();
+        size_t index = Home(key);
 
-        while (true) {
-            if (m_data[currentIndex].empty) {
-                goto NEXT_ENTRY;
+        for (size_t i = 0; i < capacity; i++) {
+            if (entries[index].empty) {
+                return -1;
             }
 
-            if (key == m_data[currentIndex].first) {
-                return true;
+            if (key == entries[index].first) {
+                return (i64)index;
             }
 
-NEXT_ENTRY:
-            currentIndex = (currentIndex + 1) % Capacity;
-
-            // key not in map
-            if (index == currentIndex) {
-                return false;
-            }
+            index = (index + 1) % capacity;
         }
 
-        return false;
+        return -1;
     }
 
-    bool Full() const {
-        return m_size == Capacity;
+    size_t m_size = 0;
+};
+
+template<typename K, typename V, size_t Cap>
+class Map : public MapBase<K, V, Map<K, V, Cap>> {
+public:
+    MapEntry<K, V>* EntryData() {
+        return m_data;
     }
 
-    bool Empty() const {
-        return m_size == 0;
+    const MapEntry<K, V>* EntryData() const {
+        return m_data;
+    }
+
+    size_t EntryCapacity() const {
+        return Cap;
     }
 
 private:
-    size_t m_size = 0;
-    MapEntry<K, V> m_data[Capacity] = {};
+    MapEntry<K, V> m_data[Cap] = {};
+};
+
+// Map with a capacity picked at runtime, the entries come from an Arena
+template<typename K, typename V>
+class ArenaMap : public MapBase<K, V, ArenaMap<K, V>> {
+public:
+    ArenaMap() = default;
+
+    ArenaMap(Arena& arena, size_t capacity)
+        : m_data(arena.Alloc<MapEntry<K, V>>(capacity)), m_capacity(capacity) {}
+
+    MapEntry<K, V>* EntryData() {
+        return m_data;
+    }
+
+    const MapEntry<K, V>* EntryData() const {
+        return m_data;
+    }
+
+    size_t EntryCapacity() const {
+        return m_capacity;
+    }
+
+private:
+    MapEntry<K, V>* m_data = NULL;
+    size_t m_capacity      = 0;
 };
 
 #endif
\ No newline at end of file
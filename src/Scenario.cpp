@@ -0,0 +1,157 @@
+#include "core/Jobs.h"
+#include "core/Random.h"
+#include "core/Timing.h"
+#include "core/Util.h"
+#include "entity/World.h"
+#include "Scenario.h"
+#include "Simulation.h"
+
+#include <memory>
+#include <vector>
+
+ScenarioResult Scenario::Run(const ScenarioDesc& desc, u32 index) {
+    // Random::Stream would jump index times, seeding the whole batch in O(count^2)
+    u64 state = index;
+    RandomStream random = Random::Seeded(desc.seed ^ Random::SplitMix64(state));
+
+    // far too big for a worker stack
+    std::unique_ptr<World> world = std::make_unique<World>();
+
+    // no camera, everything is in focus and runs every tick
+    Rect everything = { .position = {}, .size = desc.bounds };
+
+    SimSettings settings = {
+        .bounds        = desc.bounds,
+        .arrivalRadius = 32.0f,
+        .cruiseSpeed   = 75.0f,
+        .focus         = everything,
+        .nearby        = everything,
+
+        // the scenarios themselves are spread over the job threads
+        .parallel      = false,
+    };
+
+    world->SetSeed(Random::NextU64(random));
+    world->SetContext(&settings);
+    AddSimulationSystems(*world);
+
+    // not colliders, pushing apart jams this much traffic on crossing routes
+    Prefab prefab = {
+        .flags = TRANSFORM | MOTION | PATH,
+        .init  = {
+            .transform = { .size = { 80, 80 } },
+        },
+    };
+
+    u32 planeCount    = (desc.planeCount < MAX_ENTITY_COUNT) ? desc.planeCount : MAX_ENTITY_COUNT;
+    u32 waypointCount = (desc.waypointCount < MAX_PATH_SIZE) ? desc.waypointCount : MAX_PATH_SIZE;
+
+    std::vector<EntityID> ids(planeCount);
+    EntityData* planes = world->CreateEntities(prefab, planeCount, ids.data());
+
+    for (u32 i = 0; i < planeCount; i++) {
+        Transform& transform = planes[i].transform;
+        Motion& motion       = planes[i].motion;
+
+        transform.position.x = Random::Range(random, 0.0f, desc.bounds.x);
+        transform.position.y = Random::Range(random, 0.0f, desc.bounds.y);
+
+        f32 angle = Random::Range(random, 0.0f, 2.0f * PI);
+
+        motion.velocity.x = settings.cruiseSpeed * cosf(angle);
+        motion.velocity.y = settings.cruiseSpeed * sinf(angle);
+
+        for (u32 j = 0; j < waypointCount; j++) {
+            planes[i].path.Push({
+                Random::Range(random, 0.0f, desc.bounds.x),
+                Random::Range(random, 0.0f, desc.bounds.y),
+            });
+        }
+    }
+
+    // tick each route was finished on, 0 while it is still being flown
+    std::vector<u32> completedAt(planeCount, 0);
+
+    f32 deltaTime = 1.0f / desc.tickRate;
+
+    for (u32 tick = 1; tick <= desc.ticks; tick++) {
+        world->BeginTick(deltaTime);
+        world->RunSystems();
+
+        for (u32 i = 0; i < planeCount; i++) {
+            // PathSystem stops following a path with less than 2 points left
+            if (completedAt[i] == 0 && world->GetEntityData(ids[i])->path.Remaining() < 2) {
+                completedAt[i] = tick;
+            }
+        }
+    }
+
+    ScenarioResult result = {
+        .stateHash = world->Hash(),
+        .routes    = planeCount,
+    };
+
+    u64 completedTicks = 0;
+
+    for (u32 i = 0; i < planeCount; i++) {
+        if (completedAt[i] != 0) {
+            result.routesCompleted += 1;
+            completedTicks += completedAt[i];
+        }
+    }
+
+    if (result.routesCompleted > 0) {
+        result.meanCompletionTime = (f32)((f64)completedTicks / result.routesCompleted * deltaTime);
+    }
+
+    return result;
+}
+
+ScenarioSummary Scenario::RunBatch(const ScenarioDesc& desc, ScenarioResult* results) {
+    u64 start = Timing::Now();
+
+    // one scenario is plenty of work, so any thread may take a single one
+    u32 chunkCount = Jobs::ChunkCount(desc.count, 1);
+
+    Jobs::ParallelFor(desc.count, chunkCount, [&](usize first, usize last, u32 chunk) {
+        for (usize i = first; i < last; i++) {
+            results[i] = Run(desc, (u32)i);
+        }
+    });
+
+    ScenarioSummary summary = {
+        .scenarios = desc.count,
+        .batchHash = Util::HASH_SEED,
+    };
+
+    f64 totalTime = 0.0;
+
+    for (u32 i = 0; i < desc.count; i++) {
+        const ScenarioResult& result = results[i];
+
+        summary.routes += result.routes;
+        summary.routesCompleted += result.routesCompleted;
+        totalTime += (f64)result.meanCompletionTime * result.routesCompleted;
+
+        if (result.routesCompleted > 0) {
+            bool first = (summary.routesCompleted == result.routesCompleted);
+
+            if (first || result.meanCompletionTime < summary.minCompletionTime) {
+                summary.minCompletionTime = result.meanCompletionTime;
+            }
+
+            if (first || result.meanCompletionTime > summary.maxCompletionTime) {
+                summary.maxCompletionTime = result.meanCompletionTime;
+            }
+        }
+
+        summary.batchHash = Util::HashBytes(summary.batchHash, &result.stateHash, sizeof(result.stateHash));
+    }
+
+    if (summary.routesCompleted > 0) {
+        summary.meanCompletionTime = totalTime / summary.routesCompleted;
+    }
+
+    summary.wallTime = Timing::ToSeconds(Timing::Now() - start);
+    return summary;
+}
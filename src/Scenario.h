@@ -0,0 +1,52 @@
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+#include "Basic.h"
+#include "LinearMath.h"
+
+// a batch of headless monte carlo runs. every scenario gets its own world,
+// random stream and settings, so scenarios run in parallel without sharing
+// anything and the results only depend on the seed
+struct ScenarioDesc {
+    u64 seed;
+    u32 count;
+
+    u32 planeCount;
+    u32 waypointCount;  // per plane, scattered over bounds
+
+    u32 ticks;
+    f32 tickRate;
+    Vec2 bounds;
+};
+
+struct ScenarioResult {
+    u64 stateHash;          // World::Hash after the last tick
+    u32 routes;             // one per plane, after clamping to MAX_ENTITY_COUNT
+    u32 routesCompleted;
+    f32 meanCompletionTime; // seconds, over the completed routes
+};
+
+struct ScenarioSummary {
+    u32 scenarios;
+    u32 routes;
+    u32 routesCompleted;
+
+    // over completed routes, and the spread of the per scenario means
+    f64 meanCompletionTime;
+    f64 minCompletionTime;
+    f64 maxCompletionTime;
+
+    // all result hashes combined in scenario order, equal for equal descs
+    u64 batchHash;
+    f64 wallTime;
+};
+
+namespace Scenario {
+    // scenario index of the batch described by desc
+    ScenarioResult Run(const ScenarioDesc& desc, u32 index);
+
+    // spreads the scenarios over the job threads, results needs desc.count entries
+    ScenarioSummary RunBatch(const ScenarioDesc& desc, ScenarioResult* results);
+}
+
+#endif
@@ -0,0 +1,136 @@
+#include "Simulation.h"
+
+// runs first every tick
+void LODSystem(World* world) {
+    SimSettings& settings = world->Context<SimSettings>();
+
+    for (int i = 0; i < LOD_TIER_COUNT; i++) {
+        settings.lodCounts[i] = 0;
+    }
+
+    world->Each<WorldMatrix>([&](EntityData& entity, WorldMatrix& worldMatrix) {
+        Rect bounds = BoundingRect(worldMatrix.matrix);
+
+        if (entity.id == settings.focusEntity || bounds.Overlaps(settings.focus)) {
+            entity.lodTier = LOD_NEAR;
+        }
+        else if (bounds.Overlaps(settings.nearby)) {
+            entity.lodTier = LOD_MID;
+        }
+        else {
+            entity.lodTier = LOD_FAR;
+        }
+
+        settings.lodCounts[entity.lodTier] += 1;
+    });
+}
+
+void PathSystem(World* world) {
+    const SimSettings& settings = world->Context<SimSettings>();
+
+    world->EachDue<Transform, Motion, Path>([&](Transform& transform, Motion& motion, Path& path, f32 deltaTime) {
+        if (path.Remaining() < 2) {
+            motion.acceleration = {};
+            motion.velocity = motion.velocity.Normalized() * settings.cruiseSpeed;
+            return;
+        }
+
+        Vec2 targetPoint = path.Target();
+        Vec2 moveVector  = targetPoint - transform.position;
+
+        //TODO: the position of this entity, is actually at the 
+        //      center of any texture that we may draw. we should 
+        //      move on to the next point if the target point is within 
+        //      the rect that contains the texture (i.e. use tranform.size)
+        if (moveVector.Length() <= settings.arrivalRadius) {
+            path.Advance();
+
+            targetPoint = path.Target();
+            moveVector = targetPoint - transform.position;
+        }
+
+        Vec2 targetVelocity = moveVector.Normalized() * settings.cruiseSpeed;
+        motion.acceleration = targetVelocity - motion.velocity;
+    });
+}
+
+void MotionSystem(World* world) {
+    const SimSettings& settings = world->Context<SimSettings>();
+
+    world->EachDue<Transform, Motion>([&](EntityData& entity, Transform& transform, Motion& motion, f32 deltaTime) {
+        motion.velocity    += motion.acceleration * deltaTime;
+        transform.position += motion.velocity * deltaTime;
+
+        // always back towards the inside, a plane pushed out by a collision
+        // would otherwise flip every tick and never make it back
+        if (transform.position.x < 0) {
+            motion.velocity.x = fabsf(motion.velocity.x);
+        }
+        else if (transform.position.x > settings.bounds.x) {
+            motion.velocity.x = -fabsf(motion.velocity.x);
+        }
+
+        if (transform.position.y < 0) {
+            motion.velocity.y = fabsf(motion.velocity.y);
+        }
+        else if (transform.position.y > settings.bounds.y) {
+            motion.velocity.y = -fabsf(motion.velocity.y);
+        }
+
+        transform.rotation = motion.velocity.Angle();
+
+        world->MarkDirty(&entity, DIRTY_TRANSFORM);
+    });
+}
+
+// runs every tick whatever the LOD, so nothing is left overlapping. colliders
+// are pushed apart along the contact normal and bounce off each other like
+// equal masses, a collider without motion does not move
+void CollisionSystem(World* world) {
+    const SimSettings& settings = world->Context<SimSettings>();
+
+    CollisionDetector& collisions = world->Collisions();
+    collisions.Detect(world->Entities(), world->EntityCount(), settings.parallel);
+
+    EntityData* entities    = world->Entities();
+    const Contact* contacts = collisions.Contacts();
+
+    for (usize i = 0; i < collisions.ContactCount(); i++) {
+        const Contact& contact = contacts[i];
+
+        EntityData& a = entities[contact.a];
+        EntityData& b = entities[contact.b];
+
+        f32 weightA = (a.flags & MOTION) ? 1.0f : 0.0f;
+        f32 weightB = (b.flags & MOTION) ? 1.0f : 0.0f;
+
+        if (weightA + weightB == 0.0f) {
+            continue;
+        }
+
+        Vec2 push = contact.normal * (contact.depth / (weightA + weightB));
+
+        a.transform.position += push * -weightA;
+        b.transform.position += push * weightB;
+
+        // only when closing in, pairs that already separate are left alone
+        if (weightA > 0.0f && weightB > 0.0f) {
+            f32 approach = (b.motion.velocity - a.motion.velocity).Dot(contact.normal);
+
+            if (approach < 0.0f) {
+                a.motion.velocity += contact.normal * approach;
+                b.motion.velocity += contact.normal * -approach;
+            }
+        }
+
+        world->MarkDirty(&a, DIRTY_TRANSFORM);
+        world->MarkDirty(&b, DIRTY_TRANSFORM);
+    }
+}
+
+void AddSimulationSystems(World& world) {
+    world.AddSystem(LODSystem);
+    world.AddSystem(PathSystem, TRAFFIC_RATE);
+    world.AddSystem(MotionSystem, TRAFFIC_RATE);
+    world.AddSystem(CollisionSystem);
+}
@@ -0,0 +1,40 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include "entity/World.h"
+
+// everything the simulation systems read besides the entities, set as the
+// world context. each world has its own, so worlds never share state
+struct SimSettings {
+    // planes bounce off the edges of [0, bounds]
+    Vec2 bounds;
+
+    // a waypoint counts as reached within this distance
+    f32 arrivalRadius;
+    f32 cruiseSpeed;
+
+    // entities overlapping focus, and focusEntity, are near, the ones
+    // overlapping nearby are mid, everything else is far
+    Rect focus;
+    Rect nearby;
+    EntityID focusEntity;
+
+    // systems may use the job threads, false for a world that is itself stepped on one
+    bool parallel;
+
+    // entities per LOD tier as of the last tick, written by LODSystem
+    u32 lodCounts[LOD_TIER_COUNT];
+};
+
+// entities in focus run every tick, background traffic at a fraction of the rate
+inline constexpr UpdateRate TRAFFIC_RATE = {{ 1, 2, 4 }};
+
+void LODSystem(World* world);
+void PathSystem(World* world);
+void MotionSystem(World* world);
+void CollisionSystem(World* world);
+
+// the simulation systems in the order they have to run
+void AddSimulationSystems(World& world);
+
+#endif
@@ -1,5 +1,12 @@
 #include "Application.h"
+#include "Input.h"
+#include "Jobs.h"
+#include "Memory.h"
+#include "Random.h"
+#include "Replay.h"
+#include "renderer/DebugDraw.h"
 #include "renderer/Renderer2D.h"
+#include "renderer/Shader.h"
 
 #include <iostream>
 
@@ -15,12 +22,7 @@ enum ErrorType {
     ERROR_INIT,
     ERROR_GL_CONTEXT,
     ERROR_GL_LOAD,
-};
-
-struct InputButton {
-    bool down;
-    bool pressed;
-    bool released;
+    ERROR_REPLAY,
 };
 
 // platform stuff
@@ -28,13 +30,25 @@ static SDL_Window* m_window;
 static SDL_GLContext m_context;
 static bool m_running;
 
+// false for the software and null backends, there is no context, swap or imgui draw
+static bool m_useGL;
+
 static TimeStep m_timeStep;
 
-#define MAX_KEY_COUNT 256
-#define MAX_BUTTON_COUNT 6
+// frame length the limiter paces to, 0 when frames are not limited
+static u64 m_frameTicks;
+static AppStateHashCB m_stateHash;
+static int m_exitCode;
 
-static InputButton m_keys[MAX_KEY_COUNT];
-static InputButton m_buttons[MAX_BUTTON_COUNT];
+static constexpr usize FRAME_ARENA_SIZE = 4 * 1024 * 1024;
+static constexpr const char* PROGRAM_CACHE_DIRECTORY = "cache/shaders";
+
+static Vec2 m_mousePos;
+
+// the input consumed by the current frame, recorded or replayed
+static ReplayFrame m_frame;
+static u64 m_replayFrameCount;
+static u64 m_replayStartTime;
 
 static void InitImGui() {
     ImGui::CreateContext();
@@ -43,23 +57,241 @@ static void InitImGui() {
     ImGuiIO& io = ImGui::GetIO();
     io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
 
-    ImGui_ImplSDL2_InitForOpenGL(m_window, m_context);
-    ImGui_ImplOpenGL3_Init("#version 100");
+    if (m_useGL) {
+        ImGui_ImplSDL2_InitForOpenGL(m_window, m_context);
+        ImGui_ImplOpenGL3_Init("#version 100");
+    }
+    else {
+        ImGui_ImplSDL2_InitForOther(m_window);
+
+        // windows are still laid out, nothing draws them, but the font atlas has to exist
+        unsigned char* pixels;
+        int width, height;
+        io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+    }
 }
 
 static void ShutdownImGui() {
-    ImGui_ImplOpenGL3_Shutdown();
+    if (m_useGL) {
+        ImGui_ImplOpenGL3_Shutdown();
+    }
+
     ImGui_ImplSDL2_Shutdown();
     ImGui::DestroyContext();
 }
 
-void TimeStep::Update() {
-    m_startTime = SDL_GetTicks64();
-    m_deltaTime = (float)(m_startTime - m_endTime) / 1000;
-    m_endTime = m_startTime;
+// window events are handled here, everything else goes through the input queue
+static void QueueInputEvent(const InputEvent& event) {
+    if (event.type == INPUT_EVENT_WINDOW_SIZE) {
+        Renderer2D::SetViewport(event.x, event.y);
+        return;
+    }
+
+    Input::PushEvent(event);
+}
+
+// live input, translated into input events so it can be recorded
+static void PollEvents() {
+    SDL_Event event;
+
+    while (SDL_PollEvent(&event)) {
+        ImGui_ImplSDL2_ProcessEvent(&event);
+
+        InputEvent input = {};
+
+        switch (event.type) {
+            case SDL_QUIT: {
+                m_running = false;
+                continue;
+            }
+
+            case SDL_WINDOWEVENT: {
+                if (event.window.event != SDL_WINDOWEVENT_SIZE_CHANGED) {
+                    continue;
+                }
+
+                input.type = INPUT_EVENT_WINDOW_SIZE;
+                input.x    = event.window.data1;
+                input.y    = event.window.data2;
+
+                break;
+            }
+
+            case SDL_KEYUP:
+            case SDL_KEYDOWN: {
+                input.type   = INPUT_EVENT_KEY;
+                input.down   = (event.key.state == SDL_PRESSED);
+                input.repeat = (event.key.repeat != 0);
+                input.code   = event.key.keysym.scancode;
+
+                break;
+            }
+
+            case SDL_MOUSEBUTTONUP:
+            case SDL_MOUSEBUTTONDOWN: {
+                input.type = INPUT_EVENT_MOUSE_BUTTON;
+                input.down = (event.button.state == SDL_PRESSED);
+                input.code = event.button.button;
+
+                break;
+            }
+
+            default: {
+                continue;
+            }
+        }
+
+        input.timestamp = event.common.timestamp;
+
+        QueueInputEvent(input);
+
+        if (!m_frame.events.Full()) {
+            m_frame.events.Push(input);
+        }
+    }
+
+    int x, y;
+    SDL_GetMouseState(&x, &y);
+
+    m_mousePos = { (f32)x, (f32)y };
+}
+
+// imgui decides what the game gets to see, so it has to see the replayed input too
+static void ForwardToImGui(const InputEvent& input) {
+    SDL_Event event = {};
+
+    switch (input.type) {
+        case INPUT_EVENT_KEY: {
+            event.type                = input.down ? SDL_KEYDOWN : SDL_KEYUP;
+            event.key.windowID        = SDL_GetWindowID(m_window);
+            event.key.state           = input.down ? SDL_PRESSED : SDL_RELEASED;
+            event.key.repeat          = input.repeat;
+            event.key.keysym.scancode = (SDL_Scancode)input.code;
+            event.key.keysym.sym      = SDL_GetKeyFromScancode((SDL_Scancode)input.code);
+            break;
+        }
+
+        case INPUT_EVENT_MOUSE_BUTTON: {
+            event.type            = input.down ? SDL_MOUSEBUTTONDOWN : SDL_MOUSEBUTTONUP;
+            event.button.windowID = SDL_GetWindowID(m_window);
+            event.button.state    = input.down ? SDL_PRESSED : SDL_RELEASED;
+            event.button.button   = input.code;
+            event.button.x        = (int)m_mousePos.x;
+            event.button.y        = (int)m_mousePos.y;
+            break;
+        }
+
+        case INPUT_EVENT_WINDOW_SIZE: {
+            SDL_SetWindowSize(m_window, input.x, input.y);
+            return;
+        }
+    }
+
+    ImGui_ImplSDL2_ProcessEvent(&event);
+}
+
+// replayed input, the live event queue is only drained for quit requests
+static bool ReplayEvents() {
+    SDL_Event event;
+
+    while (SDL_PollEvent(&event)) {
+        if (event.type == SDL_QUIT) {
+            m_running = false;
+        }
+    }
+
+    if (!Replay::ReadFrame(m_frame)) {
+        return false;
+    }
+
+    m_timeStep.Override(m_frame.deltaTime);
+    m_mousePos = m_frame.mousePos;
+
+    SDL_Event motion = {};
+    motion.type            = SDL_MOUSEMOTION;
+    motion.motion.windowID = SDL_GetWindowID(m_window);
+    motion.motion.x        = (int)m_mousePos.x;
+    motion.motion.y        = (int)m_mousePos.y;
+
+    ImGui_ImplSDL2_ProcessEvent(&motion);
+
+    for (usize i = 0; i < m_frame.events.Size(); i++) {
+        // recorded timestamps belong to another run
+        InputEvent input = m_frame.events[i];
+        input.timestamp  = SDL_GetTicks();
+
+        ForwardToImGui(input);
+        QueueInputEvent(input);
+    }
+
+    return true;
+}
+
+static void EndFrameReplay() {
+    if (!Replay::Recording() && !Replay::Playing()) {
+        return;
+    }
+
+    u64 stateHash = m_stateHash ? m_stateHash() : 0;
+
+    if (Replay::Recording()) {
+        m_frame.deltaTime = m_timeStep.DeltaTime();
+        m_frame.mousePos  = m_mousePos;
+        m_frame.stateHash = stateHash;
+
+        Replay::WriteFrame(m_frame);
+    }
+
+    if (Replay::Playing() && stateHash != m_frame.stateHash) {
+        std::cout << "ERROR: Replay diverged at frame " << m_replayFrameCount << " (expected hash " << m_frame.stateHash << ", got " << stateHash << ")" << std::endl;
+
+        m_exitCode = 1;
+        m_running  = false;
+    }
+
+    m_replayFrameCount++;
+}
+
+static void PrintReplayStats() {
+    f64 seconds = Timing::ToSeconds(Timing::Now() - m_replayStartTime);
+    f64 frameMS = m_replayFrameCount ? (seconds * 1000.0) / m_replayFrameCount : 0.0;
+
+    std::cout << "Replay: " << m_replayFrameCount << " frames in " << seconds << " s, " << frameMS << " ms/frame" << std::endl;
 }
 
 void Application::Init(const AppDesc& desc) {
+    int windowWidth  = desc.windowWidth;
+    int windowHeight = desc.windowHeight;
+
+    m_useGL = (desc.renderBackend == Renderer2D::RENDER_BACKEND_GL);
+    bool headless = desc.headless || !m_useGL;
+
+    /* INIT REPLAY */
+
+    if (!desc.replayFile.empty()) {
+        ReplayHeader header;
+
+        if (!Replay::StartPlayback(desc.replayFile, header)) {
+            std::exit(ERROR_REPLAY);
+        }
+
+        windowWidth  = header.windowWidth;
+        windowHeight = header.windowHeight;
+
+        Random::SetSeed(header.seed);
+    }
+    else if (!desc.recordFile.empty()) {
+        ReplayHeader header = {
+            .seed         = Random::Seed(),
+            .windowWidth  = windowWidth,
+            .windowHeight = windowHeight,
+        };
+
+        if (!Replay::StartRecording(desc.recordFile, header)) {
+            std::exit(ERROR_REPLAY);
+        }
+    }
+
     /* INIT SUBSYSTEMS */
 
     if (SDL_Init(SDL_INIT_VIDEO)) {
@@ -67,49 +299,87 @@ void Application::Init(const AppDesc& desc) {
         std::exit(ERROR_INIT);
     }
 
-    /* INIT OPENGL CONTEXT */
-    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_ES);
-    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 2);
-    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 0);
+    u32 windowFlags = SDL_WINDOW_RESIZABLE;
 
-    m_window = SDL_CreateWindow(desc.windowTitle.c_str(), SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, desc.windowWidth, desc.windowHeight, SDL_WINDOW_OPENGL);
+    if (headless) {
+        windowFlags |= SDL_WINDOW_HIDDEN;
+    }
 
-    if (!m_window) {
-        std::cout << "ERROR: " << SDL_GetError() << std::endl;
-        std::exit(ERROR_GL_CONTEXT);
+    if (m_useGL) {
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_ES);
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 2);
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 0);
+
+        windowFlags |= SDL_WINDOW_OPENGL;
     }
 
-    m_context = SDL_GL_CreateContext(m_window);
+    m_window = SDL_CreateWindow(desc.windowTitle.c_str(), SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, windowWidth, windowHeight, windowFlags);
 
-    if (!m_context) {
+    if (!m_window) {
         std::cout << "ERROR: " << SDL_GetError() << std::endl;
         std::exit(ERROR_GL_CONTEXT);
     }
 
-    if (SDL_GL_MakeCurrent(m_window, m_context)) {
-        std::cout << "ERROR: " << SDL_GetError() << std::endl;
-        std::exit(ERROR_GL_CONTEXT);
+    /* INIT OPENGL CONTEXT */
+    if (m_useGL) {
+        m_context = SDL_GL_CreateContext(m_window);
+
+        if (!m_context) {
+            std::cout << "ERROR: " << SDL_GetError() << std::endl;
+            std::exit(ERROR_GL_CONTEXT);
+        }
+
+        if (SDL_GL_MakeCurrent(m_window, m_context)) {
+            std::cout << "ERROR: " << SDL_GetError() << std::endl;
+            std::exit(ERROR_GL_CONTEXT);
+        }
+
+        if (!gladLoadGLES2Loader((GLADloadproc)SDL_GL_GetProcAddress)) {
+            std::cout << "ERROR: GLAD failed to load opengl functions" << std::endl;
+            std::exit(ERROR_GL_LOAD);
+        }
+
+        SDL_GL_SetSwapInterval((headless || desc.disableVsync) ? 0 : 1);
     }
 
-    if (!gladLoadGLES2Loader((GLADloadproc)SDL_GL_GetProcAddress)) {
-        std::cout << "ERROR: GLAD failed to load opengl functions" << std::endl;
-        std::exit(ERROR_GL_LOAD);
+    /* MISC */
+    m_timeStep.SetFixedStep(desc.fixedTimeStep);
+
+    if (desc.frameRateLimit > 0) {
+        m_frameTicks = Timing::FromSeconds(1.0 / desc.frameRateLimit);
     }
 
-    SDL_GL_SetSwapInterval(1);
+    Memory::Init(FRAME_ARENA_SIZE);
+    Jobs::Init(desc.threadCount);
 
-    /* MISC */
-    Renderer2D::Init();
+    if (m_useGL) {
+        Renderer2D::InitProgramCache(PROGRAM_CACHE_DIRECTORY, SDL_GL_GetProcAddress);
+    }
+
+    Renderer2D::Init(windowWidth, windowHeight, desc.renderBackend);
+    DebugDraw::Init();
     InitImGui();
 
     m_running = true;
 }
 
 void Application::Shutdown() {
+    if (Replay::Playing()) {
+        PrintReplayStats();
+    }
+
+    Replay::Stop();
+
     ShutdownImGui();
+    DebugDraw::Shutdown();
     Renderer2D::Shutdown();
+    Jobs::Shutdown();
+    Memory::Shutdown();
+
+    if (m_useGL) {
+        SDL_GL_DeleteContext(m_context);
+    }
 
-    SDL_GL_DeleteContext(m_context);
     SDL_DestroyWindow(m_window);
 
     SDL_Quit();
@@ -120,85 +390,71 @@ void Application::Run(AppInitCB onInit, AppUpdateCB onUpdate) {
         onInit();
     }
 
+    m_replayStartTime = Timing::Now();
+
     while (m_running) {
+        Memory::BeginFrame();
         m_timeStep.Update();
         
-        for (int i = 0; i < MAX_KEY_COUNT; i++) {
-            m_keys[i].pressed  = false;
-            m_keys[i].released = false;
-        }
+        m_frame.events.Clear();
 
-        for (int i = 0; i < MAX_BUTTON_COUNT; i++) {
-            m_buttons[i].pressed  = false;
-            m_buttons[i].released = false;
+        if (Replay::Playing()) {
+            if (!ReplayEvents()) {
+                break;
+            }
+        }
+        else {
+            PollEvents();
         }
 
-        SDL_Event event;
-
-        while (SDL_PollEvent(&event)) {
-            ImGui_ImplSDL2_ProcessEvent(&event);
-
-            switch (event.type) {
-                case SDL_QUIT: {
-                    m_running = false;
-                    break;
-                }
-
-                case SDL_KEYUP:
-                case SDL_KEYDOWN: {
-                    int key = event.key.keysym.sym;
-
-                    if (key < 0 || key >= MAX_KEY_COUNT) {
-                        break;
-                    }
-
-                    bool isDown  = (event.key.state == SDL_PRESSED);
-                    bool wasDown = (event.key.state == SDL_RELEASED) || (event.key.repeat != 0);
-
-                    m_keys[key].down     = isDown;
-                    m_keys[key].pressed  = isDown && !wasDown;
-                    m_keys[key].released = !isDown && wasDown;
-                    
-                    break;
-                }
-
-                case SDL_MOUSEBUTTONUP:
-                case SDL_MOUSEBUTTONDOWN: {
-                    int button = event.button.button;
-
-                    if (button < 0 || button >= MAX_BUTTON_COUNT) {
-                        break;
-                    }
+        // late latch, the input the simulation sees is sampled as close to it as possible
+        Input::Latch(SDL_GetTicks(), m_mousePos);
 
-                    bool isDown  = (event.button.state == SDL_PRESSED);
-                    bool wasDown = (event.button.state == SDL_RELEASED);
+        if (onUpdate) {
+            onUpdate(m_timeStep);
+        }
 
-                    m_buttons[button].down     = isDown;
-                    m_buttons[button].pressed  = isDown && !wasDown;
-                    m_buttons[button].released = !isDown && wasDown;
+        EndFrameReplay();
+        Renderer2D::EndFrame();
 
-                    break;
-                }
-            }
+        if (m_useGL) {
+            SDL_GL_SwapWindow(m_window);
         }
 
-        if (onUpdate) {
-            onUpdate(m_timeStep);
+        if (m_frameTicks) {
+            Timing::WaitUntil(m_timeStep.FrameStart() + m_frameTicks);
         }
-
-        SDL_GL_SwapWindow(m_window);
     }
 }
 
+void Application::SetStateHashCallback(AppStateHashCB stateHash) {
+    m_stateHash = stateHash;
+}
+
+int Application::ExitCode() {
+    return m_exitCode;
+}
+
 void Application::ImGuiNewFrame() {
-    ImGui_ImplOpenGL3_NewFrame();
+    if (m_useGL) {
+        ImGui_ImplOpenGL3_NewFrame();
+    }
+
     ImGui_ImplSDL2_NewFrame();
     ImGui::NewFrame();
 }
 
 void Application::ImGuiRender() {
     ImGui::Render();
+
+    if (!m_useGL) {
+        return;
+    }
+
     ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+
+    // imgui binds its own program, buffers and textures
+    Renderer2D::InvalidateState();
 }
 
 const TimeStep& Application::FrameTime() {
@@ -206,58 +462,31 @@ const TimeStep& Application::FrameTime() {
 }
 
 bool Application::KeyDown(int key) {
-    if (key < 0 || key >= MAX_KEY_COUNT) {
-        return false;
-    }
-
-    return m_keys[key].down;
+    return Input::KeyDown(SDL_GetScancodeFromKey(key));
 }
 
 bool Application::KeyPressed(int key) {
-    if (key < 0 || key >= MAX_KEY_COUNT) {
-        return false;
-    }
-
-    return m_keys[key].pressed;
+    return Input::KeyPressed(SDL_GetScancodeFromKey(key));
 }
 
 bool Application::KeyReleased(int key) {
-    if (key < 0 || key >= MAX_KEY_COUNT) {
-        return false;
-    }
-
-    return m_keys[key].released;
+    return Input::KeyReleased(SDL_GetScancodeFromKey(key));
 }
 
 bool Application::MouseDown(int button) {
-    if (button < 0 || button >= MAX_BUTTON_COUNT) {
-        return false;
-    }
-
-    return m_buttons[button].down;
+    return Input::MouseDown(button);
 }
 
 bool Application::MousePressed(int button) {
-    if (button < 0 || button >= MAX_BUTTON_COUNT) {
-        return false;
-    }
-
-    return m_buttons[button].pressed;
+    return Input::MousePressed(button);
 }
 
 bool Application::MouseReleased(int button) {
-    if (button < 0 || button >= MAX_BUTTON_COUNT) {
-        return false;
-    }
-
-    return m_buttons[button].released;
+    return Input::MouseReleased(button);
 }
 
 Vec2 Application::MousePos() {
-    int x, y;
-    SDL_GetMouseState(&x, &y);
-
-    return { (f32)x, (f32)y };
+    return Input::MousePos();
 }
 
 Vec2 Application::WindowSize() {
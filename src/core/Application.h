@@ -2,35 +2,41 @@
 #define CORE_APPLICATION_H
 
 #include "LinearMath.h"
+#include "Timing.h"
+#include "renderer/RenderBackend.h"
 
 #include <functional>
 #include <string>
 
-class TimeStep {
-public:
-    void Update();
-
-    float DeltaTime() const {
-        return m_deltaTime;
-    }
-
-    float DeltaTimeMS() const {
-        return m_deltaTime * 1000;
-    }
-
-private:
-    uint64_t m_startTime = 0;
-    uint64_t m_endTime = 0;
-    float m_deltaTime = 0;
-};
-
 typedef std::function<void()> AppInitCB;
 typedef std::function<void(const TimeStep&)> AppUpdateCB;
+typedef std::function<u64()> AppStateHashCB;
 
 struct AppDesc {
     int windowWidth;
     int windowHeight;
     std::string windowTitle;
+
+    // hidden window and no vsync, frames run as fast as they can
+    bool headless;
+
+    // without vsync frames are paced by sleeping, 0 leaves them uncapped
+    bool disableVsync;
+    u32 frameRateLimit;
+
+    // length of a simulation tick in seconds, see TimeStep::SetFixedStep
+    f32 fixedTimeStep;
+
+    // record the input stream to a file, or replay one instead of reading
+    // live input. a replay overrides the window size and random seed
+    std::string recordFile;
+    std::string replayFile;
+
+    // the software and null backends have no gl context and are always headless
+    Renderer2D::RenderBackendType renderBackend;
+
+    // worker threads for Jobs, 0 is one per core
+    u32 threadCount;
 };
 
 namespace Application {
@@ -39,6 +45,13 @@ namespace Application {
 
     void Run(AppInitCB onInit, AppUpdateCB onUpdate);
 
+    // hashes the simulation state after every frame. recordings store the
+    // hash and replays compare against it to catch nondeterminism
+    void SetStateHashCallback(AppStateHashCB stateHash);
+
+    // non zero if a replay diverged from its recording
+    int ExitCode();
+
     void ImGuiNewFrame();
     void ImGuiRender();
 
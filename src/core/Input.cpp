@@ -0,0 +1,246 @@
+#include "Input.h"
+#include "List.h"
+#include "Map.h"
+
+#include <string.h>
+
+struct InputAction {
+    char name[MAX_ACTION_NAME];
+    ButtonState state;
+
+    // number of bound inputs held down, the action is down while any of them is
+    u32 downCount;
+};
+
+static ButtonState m_keys[INPUT_KEY_COUNT];
+static ButtonState m_buttons[INPUT_BUTTON_COUNT];
+static Vec2 m_mousePos;
+
+static List<InputAction, MAX_INPUT_ACTIONS> m_actions;
+
+// (device << 16) | code -> action
+static Map<u32, ActionID, MAX_INPUT_BINDINGS> m_bindings;
+
+static InputEvent m_queue[INPUT_QUEUE_SIZE];
+static u32 m_queueHead;
+static u32 m_queueTail;
+
+// states whose pressed/released flags were set by the last latch, each event touches at most two
+static List<ButtonState*, INPUT_QUEUE_SIZE * 2> m_changed;
+
+static u32 m_latchLatency;
+
+static u32 BindingKey(InputDevice device, i32 code) {
+    return ((u32)device << 16) | ((u32)code & 0xFFFF);
+}
+
+static bool ApplyButton(ButtonState& state, bool down) {
+    if (state.down == down) {
+        return false;
+    }
+
+    state.down     = down;
+    state.pressed  = state.pressed || down;
+    state.released = state.released || !down;
+
+    m_changed.Push(&state);
+
+    return true;
+}
+
+static void ApplyAction(InputAction& action, bool down) {
+    if (down) {
+        action.downCount += 1;
+
+        if (action.downCount == 1) {
+            ApplyButton(action.state, true);
+        }
+    }
+    else if (action.downCount > 0) {
+        action.downCount -= 1;
+
+        if (action.downCount == 0) {
+            ApplyButton(action.state, false);
+        }
+    }
+}
+
+static void ApplyEvent(const InputEvent& event) {
+    InputDevice device;
+    ButtonState* state = NULL;
+
+    // key repeats carry no new state
+    if (event.repeat) {
+        return;
+    }
+
+    if (event.type == INPUT_EVENT_KEY && event.code >= 0 && event.code < INPUT_KEY_COUNT) {
+        device = INPUT_KEYBOARD;
+        state  = &m_keys[event.code];
+    }
+    else if (event.type == INPUT_EVENT_MOUSE_BUTTON && event.code >= 0 && event.code < INPUT_BUTTON_COUNT) {
+        device = INPUT_MOUSE;
+        state  = &m_buttons[event.code];
+    }
+
+    if (!state || !ApplyButton(*state, event.down)) {
+        return;
+    }
+
+    u32 key = BindingKey(device, event.code);
+
+    if (m_bindings.Contains(key)) {
+        ApplyAction(m_actions[m_bindings.Get(key)], event.down);
+    }
+}
+
+static const ButtonState* GetAction(ActionID action) {
+    if (action >= m_actions.Size()) {
+        return NULL;
+    }
+
+    return &m_actions[action].state;
+}
+
+static const ButtonState* GetKey(i32 scancode) {
+    if (scancode < 0 || scancode >= INPUT_KEY_COUNT) {
+        return NULL;
+    }
+
+    return &m_keys[scancode];
+}
+
+static const ButtonState* GetButton(i32 button) {
+    if (button < 0 || button >= INPUT_BUTTON_COUNT) {
+        return NULL;
+    }
+
+    return &m_buttons[button];
+}
+
+ActionID Input::AddAction(const char* name) {
+    ASSERT(FindAction(name) == INVALID_ACTION);
+    ASSERT(strlen(name) < MAX_ACTION_NAME);
+
+    InputAction action = {};
+    strncpy(action.name, name, MAX_ACTION_NAME - 1);
+
+    m_actions.Push(action);
+
+    return m_actions.Size() - 1;
+}
+
+ActionID Input::FindAction(const char* name) {
+    for (usize i = 0; i < m_actions.Size(); i++) {
+        if (strcmp(m_actions[i].name, name) == 0) {
+            return i;
+        }
+    }
+
+    return INVALID_ACTION;
+}
+
+const char* Input::ActionName(ActionID action) {
+    ASSERT(action < m_actions.Size());
+    return m_actions[action].name;
+}
+
+void Input::Bind(ActionID action, InputDevice device, i32 code) {
+    ASSERT(action < m_actions.Size());
+
+    u32 key = BindingKey(device, code);
+
+    if (m_bindings.Contains(key)) {
+        m_bindings.Set(key, action);
+    }
+    else {
+        m_bindings.Add(key, action);
+    }
+}
+
+void Input::PushEvent(const InputEvent& event) {
+    // a full queue drops the newest events, 256 in one frame only happens
+    // when something is feeding garbage
+    if (m_queueHead - m_queueTail == INPUT_QUEUE_SIZE) {
+        return;
+    }
+
+    m_queue[m_queueHead & (INPUT_QUEUE_SIZE - 1)] = event;
+    m_queueHead += 1;
+}
+
+void Input::Latch(u32 time, Vec2 mousePos) {
+    for (usize i = 0; i < m_changed.Size(); i++) {
+        m_changed[i]->pressed  = false;
+        m_changed[i]->released = false;
+    }
+
+    m_changed.Clear();
+    m_latchLatency = 0;
+
+    while (m_queueTail != m_queueHead) {
+        const InputEvent& event = m_queue[m_queueTail & (INPUT_QUEUE_SIZE - 1)];
+        m_queueTail += 1;
+
+        ApplyEvent(event);
+
+        if (time > event.timestamp && time - event.timestamp > m_latchLatency) {
+            m_latchLatency = time - event.timestamp;
+        }
+    }
+
+    m_mousePos = mousePos;
+}
+
+u32 Input::LatchLatency() {
+    return m_latchLatency;
+}
+
+bool Input::ActionDown(ActionID action) {
+    const ButtonState* state = GetAction(action);
+    return state && state->down;
+}
+
+bool Input::ActionPressed(ActionID action) {
+    const ButtonState* state = GetAction(action);
+    return state && state->pressed;
+}
+
+bool Input::ActionReleased(ActionID action) {
+    const ButtonState* state = GetAction(action);
+    return state && state->released;
+}
+
+bool Input::KeyDown(i32 scancode) {
+    const ButtonState* state = GetKey(scancode);
+    return state && state->down;
+}
+
+bool Input::KeyPressed(i32 scancode) {
+    const ButtonState* state = GetKey(scancode);
+    return state && state->pressed;
+}
+
+bool Input::KeyReleased(i32 scancode) {
+    const ButtonState* state = GetKey(scancode);
+    return state && state->released;
+}
+
+bool Input::MouseDown(i32 button) {
+    const ButtonState* state = GetButton(button);
+    return state && state->down;
+}
+
+bool Input::MousePressed(i32 button) {
+    const ButtonState* state = GetButton(button);
+    return state && state->pressed;
+}
+
+bool Input::MouseReleased(i32 button) {
+    const ButtonState* state = GetButton(button);
+    return state && state->released;
+}
+
+Vec2 Input::MousePos() {
+    return m_mousePos;
+}
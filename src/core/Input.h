@@ -0,0 +1,83 @@
+#ifndef CORE_INPUT_H
+#define CORE_INPUT_H
+
+#include "LinearMath.h"
+
+#define INPUT_KEY_COUNT 512 // SDL_NUM_SCANCODES
+#define INPUT_BUTTON_COUNT 8
+#define INPUT_QUEUE_SIZE 256 // power of two
+#define MAX_INPUT_ACTIONS 64
+#define MAX_INPUT_BINDINGS 256
+#define MAX_ACTION_NAME 32
+
+#define INVALID_ACTION 0xFFFFFFFF
+
+enum InputEventType : u8 {
+    INPUT_EVENT_KEY,
+    INPUT_EVENT_MOUSE_BUTTON,
+    INPUT_EVENT_WINDOW_SIZE,
+};
+
+// the subset of an SDL event the game reacts to. code is the scancode or
+// mouse button, x and y are only used by INPUT_EVENT_WINDOW_SIZE.
+// timestamp is in SDL ticks
+struct InputEvent {
+    InputEventType type;
+    u8 down;
+    u8 repeat;
+    u8 padding;
+    i32 code;
+    i32 x;
+    i32 y;
+    u32 timestamp;
+};
+
+enum InputDevice : u8 {
+    INPUT_KEYBOARD,
+    INPUT_MOUSE,
+};
+
+struct ButtonState {
+    bool down;
+    bool pressed;
+    bool released;
+};
+
+typedef u32 ActionID;
+
+namespace Input {
+    // actions are registered once, game code then only deals in ActionIDs
+    ActionID AddAction(const char* name);
+    ActionID FindAction(const char* name);
+    const char* ActionName(ActionID action);
+
+    // an action can have several bindings, an input drives at most one action
+    void Bind(ActionID action, InputDevice device, i32 code);
+
+    // queues an event, it takes effect at the next Latch
+    void PushEvent(const InputEvent& event);
+
+    // applies every queued event, called right before the simulation so it
+    // sees the newest input. only the keys, buttons and actions that changed
+    // since the last latch are touched
+    void Latch(u32 time, Vec2 mousePos);
+
+    // age in ms of the oldest event applied by the last latch
+    u32 LatchLatency();
+
+    bool ActionDown(ActionID action);
+    bool ActionPressed(ActionID action);
+    bool ActionReleased(ActionID action);
+
+    bool KeyDown(i32 scancode);
+    bool KeyPressed(i32 scancode);
+    bool KeyReleased(i32 scancode);
+
+    bool MouseDown(i32 button);
+    bool MousePressed(i32 button);
+    bool MouseReleased(i32 button);
+
+    Vec2 MousePos();
+}
+
+#endif
@@ -0,0 +1,151 @@
+#include "Jobs.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define MAX_WORKER_THREADS 63
+
+static std::vector<std::thread> m_workers;
+
+static std::mutex m_mutex;
+static std::condition_variable m_wake;
+static std::condition_variable m_done;
+
+// the job in flight, written under the mutex before the generation changes
+static const ParallelForFunc* m_func;
+static usize m_count;
+static u32 m_chunkCount;
+static u64 m_generation;
+
+static std::atomic<u32> m_nextChunk;
+
+// workers between picking up a job and finishing it
+static u32 m_busy;
+static bool m_quit;
+
+static void RunChunks() {
+    for (;;) {
+        u32 chunk = m_nextChunk.fetch_add(1);
+
+        if (chunk >= m_chunkCount) {
+            return;
+        }
+
+        usize first = (m_count * chunk) / m_chunkCount;
+        usize last  = (m_count * (chunk + 1)) / m_chunkCount;
+
+        (*m_func)(first, last, chunk);
+    }
+}
+
+static void WorkerMain() {
+    u64 generation = 0;
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&]() { return m_quit || m_generation != generation; });
+
+            if (m_quit) {
+                return;
+            }
+
+            generation = m_generation;
+            m_busy += 1;
+        }
+
+        RunChunks();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_busy -= 1;
+        }
+
+        m_done.notify_all();
+    }
+}
+
+void Jobs::Init(u32 threadCount) {
+    ASSERT(m_workers.empty());
+
+    if (threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+    }
+
+    u32 workerCount = (threadCount > 1) ? threadCount - 1 : 0;
+    workerCount = (workerCount > MAX_WORKER_THREADS) ? MAX_WORKER_THREADS : workerCount;
+
+    m_quit = false;
+
+    for (u32 i = 0; i < workerCount; i++) {
+        m_workers.emplace_back(WorkerMain);
+    }
+}
+
+void Jobs::Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+
+    m_wake.notify_all();
+
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+
+    m_workers.clear();
+}
+
+u32 Jobs::ThreadCount() {
+    return (u32)m_workers.size() + 1;
+}
+
+u32 Jobs::ChunkCount(usize count, usize minChunkSize) {
+    if (count == 0) {
+        return 0;
+    }
+
+    usize chunks = count / (minChunkSize ? minChunkSize : 1);
+    chunks = (chunks < 1) ? 1 : chunks;
+
+    return (chunks < ThreadCount()) ? (u32)chunks : ThreadCount();
+}
+
+void Jobs::ParallelFor(usize count, u32 chunkCount, const ParallelForFunc& func) {
+    if (count == 0 || chunkCount == 0) {
+        return;
+    }
+
+    // not worth waking anyone up
+    if (chunkCount == 1 || m_workers.empty()) {
+        for (u32 chunk = 0; chunk < chunkCount; chunk++) {
+            func((count * chunk) / chunkCount, (count * (chunk + 1)) / chunkCount, chunk);
+        }
+
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        // a worker that woke up late for the last job may still be looking at it
+        m_done.wait(lock, []() { return m_busy == 0; });
+
+        m_func       = &func;
+        m_count      = count;
+        m_chunkCount = chunkCount;
+        m_nextChunk  = 0;
+        m_generation += 1;
+    }
+
+    m_wake.notify_all();
+
+    RunChunks();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, []() { return m_busy == 0; });
+}
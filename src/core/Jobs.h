@@ -0,0 +1,31 @@
+#ifndef CORE_JOBS_H
+#define CORE_JOBS_H
+
+#include "Basic.h"
+
+#include <functional>
+
+// fixed pool of worker threads for data parallel loops. the calling thread
+// works too and ParallelFor only returns once every chunk is done
+typedef std::function<void(usize first, usize last, u32 chunk)> ParallelForFunc;
+
+namespace Jobs {
+    // 0 picks one thread per core, the calling thread included
+    void Init(u32 threadCount = 0);
+    void Shutdown();
+
+    // workers plus the calling thread
+    u32 ThreadCount();
+
+    // chunks to split count items into, at least minChunkSize items each and
+    // never more than there are threads
+    u32 ChunkCount(usize count, usize minChunkSize);
+
+    // chunk i covers [count * i / chunkCount, count * (i + 1) / chunkCount).
+    // the ranges only depend on count and chunkCount, never on which thread
+    // runs them, so per chunk output can be combined deterministically.
+    // only the main thread may call it, jobs do not nest
+    void ParallelFor(usize count, u32 chunkCount, const ParallelForFunc& func);
+}
+
+#endif
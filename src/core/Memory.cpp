@@ -0,0 +1,66 @@
+#include "Memory.h"
+
+#include <stdlib.h>
+
+static Arena m_frameArena;
+
+static usize AlignUp(usize value, usize alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+void Arena::Init(usize capacity) {
+    Init(malloc(capacity), capacity);
+    m_owned = true;
+}
+
+void Arena::Init(void* memory, usize capacity) {
+    ASSERT(memory);
+
+    m_base     = (u8*)memory;
+    m_capacity = capacity;
+    m_offset   = 0;
+    m_peak     = 0;
+    m_owned    = false;
+}
+
+void Arena::Release() {
+    if (m_owned) {
+        free(m_base);
+    }
+
+    m_base     = NULL;
+    m_capacity = 0;
+    m_offset   = 0;
+    m_owned    = false;
+}
+
+void* Arena::Alloc(usize size, usize alignment) {
+    usize offset = AlignUp((usize)m_base + m_offset, alignment) - (usize)m_base;
+
+    // running out of scratch space is a sizing bug, not something to recover from
+    ASSERT(offset + size <= m_capacity);
+
+    m_offset = offset + size;
+
+    if (m_offset > m_peak) {
+        m_peak = m_offset;
+    }
+
+    return m_base + offset;
+}
+
+void Memory::Init(usize frameArenaSize) {
+    m_frameArena.Init(frameArenaSize);
+}
+
+void Memory::Shutdown() {
+    m_frameArena.Release();
+}
+
+Arena& Memory::FrameArena() {
+    return m_frameArena;
+}
+
+void Memory::BeginFrame() {
+    m_frameArena.Reset();
+}
@@ -0,0 +1,157 @@
+#ifndef CORE_MEMORY_H
+#define CORE_MEMORY_H
+
+#include "Basic.h"
+
+#include <new>
+#include <type_traits>
+
+// linear bump allocator, individual allocations are never freed, the
+// whole arena is reset (or rewound to a mark) at once
+class Arena {
+public:
+    void Init(usize capacity);
+    void Init(void* memory, usize capacity);
+    void Release();
+
+    void* Alloc(usize size, usize alignment = alignof(max_align_t));
+
+    // storage for count objects, value initialized
+    template<typename T>
+    T* Alloc(usize count = 1) {
+        static_assert(std::is_trivially_destructible_v<T>, "arena memory is never destructed");
+
+        T* items = (T*)Alloc(sizeof(T) * count, alignof(T));
+
+        for (usize i = 0; i < count; i++) {
+            new (&items[i]) T();
+        }
+
+        return items;
+    }
+
+    void Reset() {
+        m_offset = 0;
+    }
+
+    usize Mark() const {
+        return m_offset;
+    }
+
+    void Rewind(usize mark) {
+        ASSERT(mark <= m_offset);
+        m_offset = mark;
+    }
+
+    usize Used() const {
+        return m_offset;
+    }
+
+    usize Peak() const {
+        return m_peak;
+    }
+
+    usize Capacity() const {
+        return m_capacity;
+    }
+
+private:
+    u8* m_base        = NULL;
+    usize m_capacity  = 0;
+    usize m_offset    = 0;
+    usize m_peak      = 0;
+    bool m_owned      = false;
+};
+
+// fixed capacity pool of T with an intrusive free list, Create/Destroy are O(1)
+template<typename T, size_t Cap>
+class Pool {
+public:
+    Pool() {
+        for (size_t i = 0; i < Cap; i++) {
+            m_next[i] = (u32)(i + 1);
+        }
+    }
+
+    ~Pool() {
+        for (size_t i = 0; i < Cap; i++) {
+            if (m_alive[i]) {
+                Slot(i)->~T();
+            }
+        }
+    }
+
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+
+    template<typename... Args>
+    T* Create(Args&&... args) {
+        ASSERT(!Full());
+
+        u32 index = m_freeHead;
+        m_freeHead = m_next[index];
+
+        m_alive[index] = true;
+        m_size += 1;
+
+        return new (Slot(index)) T(static_cast<Args&&>(args)...);
+    }
+
+    void Destroy(T* item) {
+        u32 index = IndexOf(item);
+        ASSERT(m_alive[index]);
+
+        item->~T();
+
+        m_alive[index] = false;
+        m_next[index]  = m_freeHead;
+        m_freeHead     = index;
+        m_size -= 1;
+    }
+
+    u32 IndexOf(const T* item) const {
+        usize index = ((const u8*)item - m_storage) / sizeof(T);
+        ASSERT(index < Cap);
+        return (u32)index;
+    }
+
+    T* Get(u32 index) {
+        ASSERT(index < Cap && m_alive[index]);
+        return Slot(index);
+    }
+
+    size_t Size() const {
+        return m_size;
+    }
+
+    size_t Capacity() const {
+        return Cap;
+    }
+
+    bool Full() const {
+        return m_size == Cap;
+    }
+
+private:
+    T* Slot(size_t index) {
+        return (T*)&m_storage[index * sizeof(T)];
+    }
+
+    alignas(T) u8 m_storage[sizeof(T) * Cap];
+    u32 m_next[Cap];
+    bool m_alive[Cap] = {};
+
+    u32 m_freeHead = 0;
+    size_t m_size  = 0;
+};
+
+namespace Memory {
+    void Init(usize frameArenaSize);
+    void Shutdown();
+
+    // scratch memory that lives until the start of the next frame
+    Arena& FrameArena();
+    void BeginFrame();
+}
+
+#endif
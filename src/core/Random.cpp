@@ -0,0 +1,92 @@
+#include "Random.h"
+
+#include <atomic>
+
+static std::atomic<u64> m_seed = 0x9E3779B97F4A7C15ull;
+static std::atomic<u32> m_seedGeneration = 1;
+static std::atomic<u64> m_nextThreadIndex = Random::SIMULATION_STREAM + 1;
+
+RandomStream Random::Seeded(u64 seed) {
+    RandomStream stream;
+
+    for (int i = 0; i < 4; i++) {
+        stream.state[i] = SplitMix64(seed);
+    }
+
+    return stream;
+}
+
+RandomStream Random::Stream(u64 seed, u64 index) {
+    RandomStream stream = Seeded(seed);
+
+    for (u64 i = 0; i < index; i++) {
+        Jump(stream);
+    }
+
+    return stream;
+}
+
+void Random::Jump(RandomStream& stream) {
+    static constexpr u64 JUMP[] = { 0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull };
+
+    u64 s0 = 0;
+    u64 s1 = 0;
+    u64 s2 = 0;
+    u64 s3 = 0;
+
+    for (int i = 0; i < 4; i++) {
+        for (int b = 0; b < 64; b++) {
+            if (JUMP[i] & (1ull << b)) {
+                s0 ^= stream.state[0];
+                s1 ^= stream.state[1];
+                s2 ^= stream.state[2];
+                s3 ^= stream.state[3];
+            }
+
+            NextU64(stream);
+        }
+    }
+
+    stream.state[0] = s0;
+    stream.state[1] = s1;
+    stream.state[2] = s2;
+    stream.state[3] = s3;
+}
+
+void Random::Fill(RandomStream& stream, u64* out, usize count) {
+    for (usize i = 0; i < count; i++) {
+        out[i] = NextU64(stream);
+    }
+}
+
+void Random::Fill(RandomStream& stream, f32* out, usize count, f32 min, f32 max) {
+    f32 scale = (max - min) * (1.0f / 16777216.0f);
+
+    for (usize i = 0; i < count; i++) {
+        out[i] = min + ((f32)(NextU64(stream) >> 40) * scale);
+    }
+}
+
+void Random::SetSeed(u64 seed) {
+    m_seed.store(seed);
+    m_nextThreadIndex.store(SIMULATION_STREAM + 1);
+    m_seedGeneration.fetch_add(1);
+}
+
+u64 Random::Seed() {
+    return m_seed.load();
+}
+
+RandomStream& Random::ThreadStream() {
+    thread_local RandomStream stream;
+    thread_local u32 generation = 0;
+
+    u32 currentGeneration = m_seedGeneration.load(std::memory_order_acquire);
+
+    if (generation != currentGeneration) {
+        stream = Stream(m_seed.load(), m_nextThreadIndex.fetch_add(1));
+        generation = currentGeneration;
+    }
+
+    return stream;
+}
@@ -0,0 +1,90 @@
+#ifndef CORE_RANDOM_H
+#define CORE_RANDOM_H
+
+#include "Basic.h"
+
+// xoshiro256** (Blackman, Vigna), 32 bytes of state, not thread safe.
+// every thread or system that needs random numbers owns its own stream
+struct RandomStream {
+    u64 state[4];
+};
+
+namespace Random {
+    // advances x by a constant and scrambles it, a bijection of the new x
+    inline u64 SplitMix64(u64& x) {
+        u64 z = (x += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // expands seed into a full state with splitmix64
+    RandomStream Seeded(u64 seed);
+
+    // stream index of seed, streams with different indices never overlap
+    // (each one starts 2^128 numbers after the previous one)
+    RandomStream Stream(u64 seed, u64 index);
+    void Jump(RandomStream& stream);
+
+    inline u64 Rotl(u64 x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    inline u64 NextU64(RandomStream& stream) {
+        u64* s = stream.state;
+
+        u64 result = Rotl(s[1] * 5, 7) * 9;
+        u64 t = s[1] << 17;
+
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+
+        s[2] ^= t;
+        s[3] = Rotl(s[3], 45);
+
+        return result;
+    }
+
+    inline u32 NextU32(RandomStream& stream) {
+        return (u32)(NextU64(stream) >> 32);
+    }
+
+    // uniform in [0, 1)
+    inline f32 NextFloat(RandomStream& stream) {
+        return (f32)(NextU64(stream) >> 40) * (1.0f / 16777216.0f);
+    }
+
+    // uniform in [min, max)
+    inline f32 Range(RandomStream& stream, f32 min, f32 max) {
+        return min + ((max - min) * NextFloat(stream));
+    }
+
+    // uniform in [min, max), the bias of the multiply is below 2^-32
+    inline i32 Range(RandomStream& stream, i32 min, i32 max) {
+        ASSERT(max > min);
+        u64 span = (u64)((i64)max - (i64)min);
+        return (i32)((i64)min + (i64)((NextU32(stream) * span) >> 32));
+    }
+
+    // batch fills, for code that wants a whole array of numbers up front
+    void Fill(RandomStream& stream, u64* out, usize count);
+    void Fill(RandomStream& stream, f32* out, usize count, f32 min, f32 max);
+
+    // Stream(Seed(), SIMULATION_STREAM) is kept for the simulation's own
+    // stream, the thread streams are numbered after it
+    inline constexpr u64 SIMULATION_STREAM = 0;
+
+    // the seed every thread stream is derived from. changing it reseeds
+    // the thread streams the next time each thread asks for its stream
+    void SetSeed(u64 seed);
+    u64 Seed();
+
+    // a stream owned by the calling thread, only deterministic for code
+    // that always runs on the same thread. deterministic simulation code
+    // should own an explicit stream instead
+    RandomStream& ThreadStream();
+}
+
+#endif
@@ -0,0 +1,104 @@
+#include "Replay.h"
+
+#include <fstream>
+#include <iostream>
+
+// file layout: ReplayHeader, then per frame
+// f32 deltaTime, f32 mouseX, f32 mouseY, u64 stateHash, u32 eventCount, InputEvent[eventCount]
+
+static std::ofstream m_output;
+static std::ifstream m_input;
+
+bool Replay::StartRecording(const std::string& filename, const ReplayHeader& header) {
+    Stop();
+
+    m_output.open(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+
+    if (!m_output) {
+        std::cout << "ERROR: Failed to open replay file for writing: " << filename << std::endl;
+        return false;
+    }
+
+    ReplayHeader fileHeader = header;
+    fileHeader.magic   = REPLAY_MAGIC;
+    fileHeader.version = REPLAY_VERSION;
+
+    m_output.write((const char*)&fileHeader, sizeof(fileHeader));
+
+    return true;
+}
+
+bool Replay::StartPlayback(const std::string& filename, ReplayHeader& header) {
+    Stop();
+
+    m_input.open(filename, std::ios::in | std::ios::binary);
+
+    if (!m_input) {
+        std::cout << "ERROR: Failed to open replay file: " << filename << std::endl;
+        return false;
+    }
+
+    m_input.read((char*)&header, sizeof(header));
+
+    if (!m_input || header.magic != REPLAY_MAGIC || header.version != REPLAY_VERSION) {
+        std::cout << "ERROR: Not a replay file or unsupported version: " << filename << std::endl;
+        m_input.close();
+        return false;
+    }
+
+    return true;
+}
+
+void Replay::Stop() {
+    if (m_output.is_open()) {
+        m_output.close();
+    }
+
+    if (m_input.is_open()) {
+        m_input.close();
+    }
+}
+
+bool Replay::Recording() {
+    return m_output.is_open();
+}
+
+bool Replay::Playing() {
+    return m_input.is_open();
+}
+
+void Replay::WriteFrame(const ReplayFrame& frame) {
+    ASSERT(Recording());
+
+    u32 eventCount = frame.events.Size();
+
+    m_output.write((const char*)&frame.deltaTime, sizeof(frame.deltaTime));
+    m_output.write((const char*)&frame.mousePos.x, sizeof(frame.mousePos.x));
+    m_output.write((const char*)&frame.mousePos.y, sizeof(frame.mousePos.y));
+    m_output.write((const char*)&frame.stateHash, sizeof(frame.stateHash));
+    m_output.write((const char*)&eventCount, sizeof(eventCount));
+    m_output.write((const char*)frame.events.Data(), eventCount * sizeof(InputEvent));
+}
+
+bool Replay::ReadFrame(ReplayFrame& frame) {
+    ASSERT(Playing());
+
+    u32 eventCount = 0;
+
+    m_input.read((char*)&frame.deltaTime, sizeof(frame.deltaTime));
+    m_input.read((char*)&frame.mousePos.x, sizeof(frame.mousePos.x));
+    m_input.read((char*)&frame.mousePos.y, sizeof(frame.mousePos.y));
+    m_input.read((char*)&frame.stateHash, sizeof(frame.stateHash));
+    m_input.read((char*)&eventCount, sizeof(eventCount));
+
+    if (!m_input || eventCount > MAX_FRAME_EVENTS) {
+        return false;
+    }
+
+    frame.events.Clear();
+    frame.events.Grow(eventCount);
+
+    m_input.read((char*)frame.events.Data(), eventCount * sizeof(InputEvent));
+
+    return (bool)m_input;
+}
@@ -0,0 +1,44 @@
+#ifndef CORE_REPLAY_H
+#define CORE_REPLAY_H
+
+#include "Input.h"
+#include "List.h"
+
+#include <string>
+
+#define REPLAY_MAGIC 0x50524C50 // "PLRP"
+#define REPLAY_VERSION 4
+#define MAX_FRAME_EVENTS 256
+
+struct ReplayHeader {
+    u32 magic;
+    u32 version;
+    u64 seed;
+    i32 windowWidth;
+    i32 windowHeight;
+};
+
+// everything the simulation consumed during one frame, plus the state
+// hash it produced so a replay can tell where it diverged
+struct ReplayFrame {
+    f32 deltaTime;
+    Vec2 mousePos;
+    u64 stateHash;
+    List<InputEvent, MAX_FRAME_EVENTS> events;
+};
+
+namespace Replay {
+    bool StartRecording(const std::string& filename, const ReplayHeader& header);
+    bool StartPlayback(const std::string& filename, ReplayHeader& header);
+    void Stop();
+
+    bool Recording();
+    bool Playing();
+
+    void WriteFrame(const ReplayFrame& frame);
+
+    // false once the recording runs out of frames
+    bool ReadFrame(ReplayFrame& frame);
+}
+
+#endif
@@ -0,0 +1,117 @@
+#include "Timing.h"
+
+#include <SDL.h>
+
+// anything longer is a stall (debugger, window drag), not a frame to simulate
+static constexpr f32 MAX_DELTA_TIME = 0.25f;
+
+// the part of a wait that is spun instead of slept
+static constexpr f64 SPIN_SECONDS = 0.002;
+
+u64 Timing::Now() {
+    return SDL_GetPerformanceCounter();
+}
+
+u64 Timing::Frequency() {
+    static u64 frequency = SDL_GetPerformanceFrequency();
+    return frequency;
+}
+
+f64 Timing::ToSeconds(u64 ticks) {
+    return (f64)ticks / (f64)Frequency();
+}
+
+u64 Timing::FromSeconds(f64 seconds) {
+    return (u64)(seconds * (f64)Frequency());
+}
+
+void Timing::WaitUntil(u64 deadline) {
+    u64 spinTicks = FromSeconds(SPIN_SECONDS);
+
+    for (;;) {
+        u64 now = Now();
+
+        if (now >= deadline) {
+            return;
+        }
+
+        u64 remaining = deadline - now;
+
+        if (remaining > spinTicks) {
+            u32 sleepMS = (u32)(ToSeconds(remaining - spinTicks) * 1000.0);
+
+            if (sleepMS > 0) {
+                SDL_Delay(sleepMS);
+                continue;
+            }
+        }
+    }
+}
+
+void TimeStep::Update() {
+    u64 now = Timing::Now();
+
+    m_carry = m_leftover;
+
+    // the first frame has nothing to measure against
+    if (m_frameStart == 0) {
+        m_frameStart = now;
+
+        Accumulate();
+        return;
+    }
+
+    f32 deltaTime = (f32)Timing::ToSeconds(now - m_frameStart);
+    m_frameStart = now;
+
+    m_rawDeltaTime = deltaTime;
+
+    m_history[m_historyIndex] = deltaTime * 1000.0f;
+    m_historyIndex = (m_historyIndex + 1) % FRAME_HISTORY_SIZE;
+
+    if (deltaTime > MAX_DELTA_TIME) {
+        deltaTime = MAX_DELTA_TIME;
+    }
+
+    m_samples[m_sampleIndex] = deltaTime;
+    m_sampleIndex = (m_sampleIndex + 1) % DELTA_SMOOTH_FRAMES;
+
+    if (m_sampleCount < DELTA_SMOOTH_FRAMES) {
+        m_sampleCount += 1;
+    }
+
+    f32 sum = 0;
+
+    for (u32 i = 0; i < m_sampleCount; i++) {
+        sum += m_samples[i];
+    }
+
+    m_deltaTime = sum / m_sampleCount;
+
+    Accumulate();
+}
+
+// starts from m_carry every time, so Override can redo the frame with another dt
+void TimeStep::Accumulate() {
+    if (m_fixedStep <= 0) {
+        m_fixedSteps = 1;
+        m_alpha      = 1;
+        return;
+    }
+
+    f32 time = m_carry + m_deltaTime;
+    m_fixedSteps = 0;
+
+    while (time >= m_fixedStep && m_fixedSteps < MAX_FIXED_STEPS) {
+        time -= m_fixedStep;
+        m_fixedSteps += 1;
+    }
+
+    // too far behind to catch up, the simulation slows down instead
+    if (time >= m_fixedStep) {
+        time = 0;
+    }
+
+    m_leftover = time;
+    m_alpha    = time / m_fixedStep;
+}
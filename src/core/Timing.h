@@ -0,0 +1,110 @@
+#ifndef CORE_TIMING_H
+#define CORE_TIMING_H
+
+#include "Basic.h"
+
+#define FRAME_HISTORY_SIZE  240
+#define DELTA_SMOOTH_FRAMES 8
+
+// fixed steps run in one frame at most, a longer backlog is dropped
+#define MAX_FIXED_STEPS 4
+
+// high resolution clock, SDL_GetPerformanceCounter underneath
+// (clock_gettime(CLOCK_MONOTONIC) on linux, QPC on windows)
+namespace Timing {
+    u64 Now();
+    u64 Frequency();
+
+    f64 ToSeconds(u64 ticks);
+    u64 FromSeconds(f64 seconds);
+
+    // sleeps while the deadline is far away, then spins the last stretch,
+    // os sleeps overshoot by up to a scheduler tick
+    void WaitUntil(u64 deadline);
+}
+
+class TimeStep {
+public:
+    // once at the start of every frame
+    void Update();
+
+    // averaged over the last few frames, a single late frame does not make
+    // the simulation jump
+    f32 DeltaTime() const {
+        return m_deltaTime;
+    }
+
+    f32 DeltaTimeMS() const {
+        return m_deltaTime * 1000;
+    }
+
+    // measured time between the last two frame starts
+    f32 RawDeltaTime() const {
+        return m_rawDeltaTime;
+    }
+
+    // replays feed the recorded delta time instead of the measured one
+    void Override(f32 deltaTime) {
+        m_deltaTime    = deltaTime;
+        m_rawDeltaTime = deltaTime;
+
+        Accumulate();
+    }
+
+    // simulation steps of a fixed length, the accumulator carries what is
+    // left over into the next frame. 0 runs one step per frame with DeltaTime
+    void SetFixedStep(f32 step) {
+        m_fixedStep = step;
+    }
+
+    // steps due this frame, can be 0 when rendering faster than the step rate
+    u32 FixedSteps() const {
+        return m_fixedSteps;
+    }
+
+    f32 FixedDeltaTime() const {
+        return (m_fixedStep > 0) ? m_fixedStep : m_deltaTime;
+    }
+
+    // how far the frame is between the last step and the next one, in [0, 1)
+    f32 Alpha() const {
+        return m_alpha;
+    }
+
+    u64 FrameStart() const {
+        return m_frameStart;
+    }
+
+    // raw frame times in ms, a ring buffer, the oldest entry is at HistoryOffset()
+    const f32* History() const {
+        return m_history;
+    }
+
+    u32 HistoryOffset() const {
+        return m_historyIndex;
+    }
+
+private:
+    void Accumulate();
+
+    u64 m_frameStart   = 0;
+    f32 m_deltaTime    = 0;
+    f32 m_rawDeltaTime = 0;
+
+    f32 m_samples[DELTA_SMOOTH_FRAMES] = {};
+    u32 m_sampleIndex = 0;
+    u32 m_sampleCount = 0;
+
+    f32 m_history[FRAME_HISTORY_SIZE] = {};
+    u32 m_historyIndex = 0;
+
+    f32 m_fixedStep  = 0;
+    u32 m_fixedSteps = 1;
+    f32 m_alpha      = 1;
+
+    // time not yet simulated when the frame started, and when it ends
+    f32 m_carry    = 0;
+    f32 m_leftover = 0;
+};
+
+#endif
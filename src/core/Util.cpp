@@ -1,33 +1,157 @@
+#include "Random.h"
 #include "Util.h"
 
 #include <fstream>
-#include <random>
-#include <sstream>
 
-// random numbers
-static std::random_device s_randomDevice;
-static std::mt19937_64 s_randomEngine(s_randomDevice());
-static std::uniform_int_distribution<u64> s_uniformDistribution;
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+u64 Util::HashBytes(u64 seed, const void* data, usize size) {
+    const u8* bytes = (const u8*)data;
+    u64 hash = seed;
+
+    for (usize i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
 
 u64 Util::RandomID() {
+    RandomStream& stream = Random::ThreadStream();
     u64 id;
 
     do {
-        id = s_uniformDistribution(s_randomEngine);
+        id = Random::NextU64(stream);
     } while (id == 0);
 
     return id;
 }
 
+// sizes the string once and reads the file in one go
+static std::string ReadFile(const std::string& filename, std::ios::openmode mode) {
+    std::ifstream file(filename, mode | std::ios::ate);
+
+    if (!file) {
+        return {};
+    }
+
+    std::string data(file.tellg(), '\0');
+
+    file.seekg(0);
+    file.read(data.data(), data.size());
+
+    // text mode may translate line endings and read fewer bytes
+    data.resize(file.gcount());
+
+    return data;
+}
+
 std::string Util::ReadEntireFile(const std::string& filename) {
-    std::string line;
-    std::fstream file(filename);
+    return ReadFile(filename, std::ios::in);
+}
+
+std::string Util::ReadBinaryFile(const std::string& filename) {
+    return ReadFile(filename, std::ios::in | std::ios::binary);
+}
+#ifdef WIN32
+
+bool Util::MapFile(const std::string& filename, MappedFile& file) {
+    file = {};
+
+    HANDLE handle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+
+    if (!GetFileSizeEx(handle, &size) || size.QuadPart == 0) {
+        CloseHandle(handle);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+
+    if (!data) {
+        if (mapping) {
+            CloseHandle(mapping);
+        }
 
-    std::stringstream stream;
+        CloseHandle(handle);
+        return false;
+    }
+
+    file = {
+        .data    = (const u8*)data,
+        .size    = (usize)size.QuadPart,
+        .file    = handle,
+        .mapping = mapping,
+    };
+
+    return true;
+}
 
-    while (std::getline(file, line)) {
-        stream << line << "\n";
+void Util::UnmapFile(MappedFile& file) {
+    if (file.data) {
+        UnmapViewOfFile(file.data);
+        CloseHandle((HANDLE)file.mapping);
+        CloseHandle((HANDLE)file.file);
     }
 
-    return stream.str();
-}
\ No newline at end of file
+    file = {};
+}
+
+#else
+
+bool Util::MapFile(const std::string& filename, MappedFile& file) {
+    file = {};
+
+    int fd = open(filename.c_str(), O_RDONLY);
+
+    if (fd == -1) {
+        return false;
+    }
+
+    struct stat info;
+
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return false;
+    }
+
+    void* data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    // the mapping keeps the file alive on its own
+    close(fd);
+
+    if (data == MAP_FAILED) {
+        return false;
+    }
+
+    file = {
+        .data = (const u8*)data,
+        .size = (usize)info.st_size,
+    };
+
+    return true;
+}
+
+void Util::UnmapFile(MappedFile& file) {
+    if (file.data) {
+        munmap((void*)file.data, file.size);
+    }
+
+    file = {};
+}
+
+#endif
@@ -5,9 +5,28 @@
 
 #include <string>
 
+// a read only view of a whole file, pages are only read in when touched
+struct MappedFile {
+    const u8* data;
+    usize size;
+
+    // platform handles, only used to unmap
+    void* file;
+    void* mapping;
+};
+
 namespace Util {
+    // FNV-1a, hashes are chained by passing the last one in as the seed
+    inline constexpr u64 HASH_SEED = 14695981039346656037ull;
+    u64 HashBytes(u64 seed, const void* data, usize size);
+
     u64 RandomID();
     std::string ReadEntireFile(const std::string& filename);
+    std::string ReadBinaryFile(const std::string& filename);
+
+    // false if the file can not be opened or is empty
+    bool MapFile(const std::string& filename, MappedFile& file);
+    void UnmapFile(MappedFile& file);
 }
 
 #endif
\ No newline at end of file
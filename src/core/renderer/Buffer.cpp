@@ -1,5 +1,6 @@
 #include "LinearMath.h"
 #include "Buffer.h"
+#include "GLState.h"
 
 #include <glad/glad.h>
 
@@ -15,17 +16,18 @@ static usize GetBufferSize(const Buffer& buffer) {
     return size;
 }
 
-Buffer Renderer2D::CreateBuffer(usize size) {
+Buffer Renderer2D::CreateBuffer(usize size, BufferUsage usage) {
     Buffer buffer = {};
 
     glGenBuffers(1, &buffer.renderID);
-    glBindBuffer(GL_ARRAY_BUFFER, buffer.renderID);
-    glBufferData(GL_ARRAY_BUFFER, size, NULL, GL_DYNAMIC_DRAW);
+    BindArrayBuffer(buffer.renderID);
+    glBufferData(GL_ARRAY_BUFFER, size, NULL, (usage == BUFFER_STATIC) ? GL_STATIC_DRAW : GL_DYNAMIC_DRAW);
 
     return buffer;
 }
 
 void Renderer2D::DestroyBuffer(Buffer& buffer) {
+    ForgetBuffer(buffer.renderID);
     glDeleteBuffers(1, &buffer.renderID);
 
     buffer.renderID = 0;
@@ -33,12 +35,19 @@ void Renderer2D::DestroyBuffer(Buffer& buffer) {
 }
 
 void Renderer2D::SetBufferData(const Buffer& buffer, usize size, const void* data) {
-    glBindBuffer(GL_ARRAY_BUFFER, buffer.renderID);
+    BindArrayBuffer(buffer.renderID);
     glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
 }
 
 void Renderer2D::EnableAttributes(const Buffer& buffer) {
-    glBindBuffer(GL_ARRAY_BUFFER, buffer.renderID);
+    SetEnabledAttributes((1u << buffer.attributes.Size()) - 1);
+
+    // the pointers already describe this buffer
+    if (AttributeBuffer() == buffer.renderID) {
+        return;
+    }
+
+    BindArrayBuffer(buffer.renderID);
 
     usize size   = GetBufferSize(buffer);
     usize offset = 0;
@@ -46,9 +55,10 @@ void Renderer2D::EnableAttributes(const Buffer& buffer) {
     for (int i = 0; i < buffer.attributes.Size(); i++) {
         const Attribute& attribute = buffer.attributes[i];
 
-        glEnableVertexAttribArray(i);
         glVertexAttribPointer(i, attribute.count, GL_FLOAT, false, size, (const void*)offset);
 
         offset += sizeof(f32) * attribute.count;
     }
+
+    SetAttributeBuffer(buffer.renderID);
 }
\ No newline at end of file
@@ -3,8 +3,6 @@
 
 #include "List.h"
 
-#include <string>
-
 namespace Renderer2D {
 
 inline constexpr int MAX_ATTRIBUTE_COUNT = 8;
@@ -13,7 +11,12 @@ inline constexpr int MAX_ATTRIBUTE_COUNT = 8;
 struct Attribute {
     int type;
     int count;
-    std::string name;
+    const char* name;
+};
+
+enum BufferUsage {
+    BUFFER_DYNAMIC, // rewritten every frame
+    BUFFER_STATIC,  // written once, rewritten rarely
 };
 
 struct Buffer {
@@ -21,7 +24,7 @@ struct Buffer {
     List<Attribute, MAX_ATTRIBUTE_COUNT> attributes;
 };
 
-Buffer CreateBuffer(usize size);
+Buffer CreateBuffer(usize size, BufferUsage usage = BUFFER_DYNAMIC);
 void DestroyBuffer(Buffer& buffer);
 void SetBufferData(const Buffer& buffer, usize size, const void* data);
 void EnableAttributes(const Buffer& buffer);
@@ -0,0 +1,30 @@
+#ifndef CORE_RENDERER_CAMERA_H
+#define CORE_RENDERER_CAMERA_H
+
+#include "LinearMath.h"
+
+struct Camera2D {
+    Vec2 position;      // world position of the top left corner of the view
+    Vec2 viewportSize;  // size of the viewport in pixels
+    f32 zoom = 1.0f;
+
+    Vec2 ViewSize() const {
+        return viewportSize * (1.0f / zoom);
+    }
+
+    // world space rect covered by the view, grown by margin on every side
+    Rect VisibleRect(f32 margin = 0.0f) const {
+        return Rect{ position, ViewSize() }.Expanded(margin);
+    }
+
+    Vec2 ScreenToWorld(const Vec2& point) const {
+        return position + (point * (1.0f / zoom));
+    }
+
+    Mat4 Projection() const {
+        Vec2 viewSize = ViewSize();
+        return OrthoProjection(position.x, position.x + viewSize.x, position.y + viewSize.y, position.y, 0, 1);
+    }
+};
+
+#endif
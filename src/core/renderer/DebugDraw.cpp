@@ -0,0 +1,246 @@
+#include "DebugDraw.h"
+
+#if DEBUG_DRAW
+
+#include "Renderer2D.h"
+#include "Map.h"
+#include "core/Memory.h"
+
+using namespace Renderer2D;
+
+#define MAX_DEBUG_VERTICES 65536
+#define MAX_RETAINED_LINES 256
+
+// frames a retained mesh survives without being drawn
+#define RETAINED_LINES_TIMEOUT 120
+
+struct RetainedLines {
+    u64 key;
+    u32 version;
+    u64 lastUsedFrame;
+
+    LineMesh mesh;
+    usize segmentVertices;
+};
+
+static const char* CATEGORY_NAMES[DEBUG_CATEGORY_COUNT] = {
+    "Bounds",
+    "Motion",
+    "Paths",
+    "Collision",
+};
+
+static u32 m_enabled = DEBUG_ALL;
+static u64 m_frame;
+
+static List<LineVertex, MAX_DEBUG_VERTICES> m_vertices;
+static LineMesh m_batchMesh;
+
+static List<RetainedLines, MAX_RETAINED_LINES> m_retained;
+static Map<u64, usize, MAX_RETAINED_LINES * 2> m_retainedIndex;
+
+static void DrawBatch() {
+    if (m_vertices.Empty()) {
+        return;
+    }
+
+    SetLineMeshData(m_batchMesh, m_vertices.Data(), m_vertices.Size());
+    DrawLineMesh(m_batchMesh, 0, m_vertices.Size());
+
+    m_vertices.Clear();
+}
+
+static void PushLine(const Vec2& start, const Vec2& end, const Vec4& color) {
+    if (m_vertices.Full()) {
+        DrawBatch();
+    }
+
+    m_vertices.Push({ start, color });
+    m_vertices.Push({ end, color });
+}
+
+static void RemoveRetained(usize index) {
+    DestroyLineMesh(m_retained[index].mesh);
+    m_retainedIndex.Remove(m_retained[index].key);
+
+    usize last = m_retained.Size() - 1;
+
+    if (index != last) {
+        m_retained[index] = m_retained[last];
+        m_retainedIndex.Set(m_retained[index].key, index);
+    }
+
+    m_retained.Truncate(last);
+}
+
+static RetainedLines& GetRetained(u64 key) {
+    if (m_retainedIndex.Contains(key)) {
+        return m_retained[m_retainedIndex.Get(key)];
+    }
+
+    // evict the least recently drawn
+    if (m_retained.Full()) {
+        usize oldest = 0;
+
+        for (usize i = 1; i < m_retained.Size(); i++) {
+            if (m_retained[i].lastUsedFrame < m_retained[oldest].lastUsedFrame) {
+                oldest = i;
+            }
+        }
+
+        RemoveRetained(oldest);
+    }
+
+    RetainedLines lines = {
+        .key     = key,
+        .version = 0xFFFFFFFF,
+    };
+
+    m_retainedIndex.Add(key, m_retained.Size());
+    m_retained.Push(lines);
+
+    return m_retained[m_retained.Size() - 1];
+}
+
+static void AppendLine(ArenaList<LineVertex>& vertices, const Vec2& start, const Vec2& end, const Vec4& color) {
+    vertices.Push({ start, color });
+    vertices.Push({ end, color });
+}
+
+// segments first, then 4 lines per marker, so a suffix of the path is two ranges
+static void BuildPolyline(RetainedLines& lines, const Vec2* points, usize count, f32 markerSize, const Vec4& color, const Vec4& markerColor) {
+    Arena& arena = Memory::FrameArena();
+    usize mark = arena.Mark();
+
+    ArenaList<LineVertex> vertices(arena, (count * 10) - 2);
+
+    for (usize i = 0; i + 1 < count; i++) {
+        AppendLine(vertices, points[i], points[i + 1], color);
+    }
+
+    lines.segmentVertices = vertices.Size();
+
+    f32 half = markerSize / 2.0f;
+
+    for (usize i = 0; i < count; i++) {
+        Vec2 tl = { points[i].x - half, points[i].y - half };
+        Vec2 tr = { points[i].x + half, points[i].y - half };
+        Vec2 br = { points[i].x + half, points[i].y + half };
+        Vec2 bl = { points[i].x - half, points[i].y + half };
+
+        AppendLine(vertices, tl, tr, markerColor);
+        AppendLine(vertices, tr, br, markerColor);
+        AppendLine(vertices, br, bl, markerColor);
+        AppendLine(vertices, bl, tl, markerColor);
+    }
+
+    if (lines.mesh.capacity < vertices.Size()) {
+        usize capacity = (lines.mesh.capacity > 0) ? lines.mesh.capacity : 64;
+
+        while (capacity < vertices.Size()) {
+            capacity *= 2;
+        }
+
+        if (lines.mesh.capacity > 0) {
+            DestroyLineMesh(lines.mesh);
+        }
+
+        lines.mesh = CreateLineMesh(capacity);
+    }
+
+    SetLineMeshData(lines.mesh, vertices.Data(), vertices.Size());
+
+    arena.Rewind(mark);
+}
+
+void DebugDraw::Init() {
+    m_batchMesh = CreateLineMesh(MAX_DEBUG_VERTICES, BUFFER_DYNAMIC);
+}
+
+void DebugDraw::Shutdown() {
+    while (!m_retained.Empty()) {
+        RemoveRetained(m_retained.Size() - 1);
+    }
+
+    DestroyLineMesh(m_batchMesh);
+}
+
+void DebugDraw::SetEnabled(u32 categories, bool enabled) {
+    if (enabled) {
+        m_enabled |= categories;
+    }
+    else {
+        m_enabled &= ~categories;
+    }
+}
+
+bool DebugDraw::Enabled(u32 category) {
+    return (m_enabled & category) != 0;
+}
+
+const char* DebugDraw::CategoryName(u32 index) {
+    ASSERT(index < DEBUG_CATEGORY_COUNT);
+    return CATEGORY_NAMES[index];
+}
+
+void DebugDraw::Line(u32 category, const Vec2& start, const Vec2& end, const Vec4& color) {
+    if (!Enabled(category)) {
+        return;
+    }
+
+    PushLine(start, end, color);
+}
+
+void DebugDraw::RectLines(u32 category, const Mat3x2& matrix, const Vec4& color) {
+    if (!Enabled(category)) {
+        return;
+    }
+
+    Vec2 corners[4];
+    TransformQuad(matrix, corners);
+
+    PushLine(corners[3], corners[2], color); // top
+    PushLine(corners[2], corners[1], color); // right
+    PushLine(corners[0], corners[1], color); // bottom
+    PushLine(corners[3], corners[0], color); // left
+}
+
+void DebugDraw::Polyline(u32 category, u64 key, u32 version, const Vec2* points, usize count, usize first, f32 markerSize, const Vec4& color, const Vec4& markerColor) {
+    if (!Enabled(category) || first >= count) {
+        return;
+    }
+
+    RetainedLines& lines = GetRetained(key);
+    lines.lastUsedFrame = m_frame;
+
+    if (lines.version != version) {
+        BuildPolyline(lines, points, count, markerSize, color, markerColor);
+        lines.version = version;
+    }
+
+    // retained draws flush the batch anyway, keep the order things were submitted in
+    DrawBatch();
+
+    usize segmentFirst = first * 2;
+    usize markerFirst  = lines.segmentVertices + (first * 8);
+
+    DrawLineMesh(lines.mesh, segmentFirst, lines.segmentVertices - segmentFirst);
+    DrawLineMesh(lines.mesh, markerFirst, lines.mesh.vertexCount - markerFirst);
+}
+
+void DebugDraw::Flush() {
+    DrawBatch();
+
+    for (usize i = 0; i < m_retained.Size();) {
+        if (m_frame - m_retained[i].lastUsedFrame > RETAINED_LINES_TIMEOUT) {
+            RemoveRetained(i);
+        }
+        else {
+            i++;
+        }
+    }
+
+    m_frame += 1;
+}
+
+#endif
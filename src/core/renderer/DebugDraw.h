@@ -0,0 +1,59 @@
+#ifndef CORE_RENDERER_DEBUG_DRAW_H
+#define CORE_RENDERER_DEBUG_DRAW_H
+
+#include "LinearMath.h"
+
+// build with DEBUG_DRAW=0 to compile every debug visual out, Enabled() is
+// then a constant false and the code behind it is removed with it
+#ifndef DEBUG_DRAW
+#define DEBUG_DRAW 1
+#endif
+
+enum DebugCategory : u32 {
+    DEBUG_BOUNDS    = 1 << 0,
+    DEBUG_MOTION    = 1 << 1,
+    DEBUG_PATHS     = 1 << 2,
+    DEBUG_COLLISION = 1 << 3,
+};
+
+inline constexpr u32 DEBUG_CATEGORY_COUNT = 4;
+inline constexpr u32 DEBUG_ALL = (1 << DEBUG_CATEGORY_COUNT) - 1;
+
+// debug visuals drawn through their own line batch. everything goes in
+// world space, between Renderer2D::Begin(camera) and Renderer2D::End()
+namespace DebugDraw {
+#if DEBUG_DRAW
+    void Init();
+    void Shutdown();
+
+    // runtime toggles, every category starts enabled
+    void SetEnabled(u32 categories, bool enabled);
+    bool Enabled(u32 category);
+    const char* CategoryName(u32 index);
+
+    void Line(u32 category, const Vec2& start, const Vec2& end, const Vec4& color);
+    void RectLines(u32 category, const Mat3x2& matrix, const Vec4& color);
+
+    // a polyline with a square marker on every point, kept on the gpu under
+    // key and only rebuilt when version changes. points before first are skipped
+    void Polyline(u32 category, u64 key, u32 version, const Vec2* points, usize count, usize first, f32 markerSize, const Vec4& color, const Vec4& markerColor);
+
+    // draws the batch, meshes that were not drawn for a while are freed here
+    void Flush();
+#else
+    inline void Init() {}
+    inline void Shutdown() {}
+
+    inline void SetEnabled(u32, bool) {}
+    inline constexpr bool Enabled(u32) { return false; }
+    inline const char* CategoryName(u32) { return ""; }
+
+    inline void Line(u32, const Vec2&, const Vec2&, const Vec4&) {}
+    inline void RectLines(u32, const Mat3x2&, const Vec4&) {}
+    inline void Polyline(u32, u64, u32, const Vec2*, usize, usize, f32, const Vec4&, const Vec4&) {}
+
+    inline void Flush() {}
+#endif
+}
+
+#endif
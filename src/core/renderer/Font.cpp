@@ -0,0 +1,152 @@
+#include "Font.h"
+#include "Renderer2D.h"
+#include "core/Util.h"
+
+#include <iostream>
+#include <string.h>
+
+#define STB_TRUETYPE_IMPLEMENTATION
+#include <stb_truetype.h>
+
+using namespace Renderer2D;
+
+static constexpr int TEXT_RUN_CACHE_SIZE = 64;
+
+// direct mapped on the text hash, a collision just re-shapes the run
+static TextRun m_runCache[TEXT_RUN_CACHE_SIZE];
+
+bool Renderer2D::LoadFont(Font& font, const char* filename, f32 pixelHeight) {
+    std::string data = Util::ReadBinaryFile(filename);
+
+    if (data.empty()) {
+        std::cout << "ERROR: Failed to read font " << filename << std::endl;
+        return false;
+    }
+
+    const u8* fontData = (const u8*)data.data();
+
+    stbtt_fontinfo info;
+
+    if (!stbtt_InitFont(&info, fontData, stbtt_GetFontOffsetForIndex(fontData, 0))) {
+        std::cout << "ERROR: Failed to parse font " << filename << std::endl;
+        return false;
+    }
+
+    u8* coverage = new u8[FONT_ATLAS_SIZE * FONT_ATLAS_SIZE];
+    stbtt_bakedchar bakedChars[FONT_CHAR_COUNT];
+
+    if (stbtt_BakeFontBitmap(fontData, 0, pixelHeight, coverage, FONT_ATLAS_SIZE, FONT_ATLAS_SIZE, FONT_FIRST_CHAR, FONT_CHAR_COUNT, bakedChars) <= 0) {
+        std::cout << "WARNING: Not every glyph of " << filename << " fit in the atlas" << std::endl;
+    }
+
+    // white texels with the glyph coverage as alpha, so the quad color tints the text
+    u32* pixels = new u32[FONT_ATLAS_SIZE * FONT_ATLAS_SIZE];
+
+    for (int i = 0; i < FONT_ATLAS_SIZE * FONT_ATLAS_SIZE; i++) {
+        pixels[i] = ((u32)coverage[i] << 24) | 0x00FFFFFF;
+    }
+
+    font.atlas = CreateTexture(FONT_ATLAS_SIZE, FONT_ATLAS_SIZE, pixels);
+
+    delete[] pixels;
+    delete[] coverage;
+
+    int ascent, descent, lineGap;
+    stbtt_GetFontVMetrics(&info, &ascent, &descent, &lineGap);
+
+    f32 scale = stbtt_ScaleForPixelHeight(&info, pixelHeight);
+
+    font.pixelHeight = pixelHeight;
+    font.ascent      = ascent * scale;
+    font.lineHeight  = (ascent - descent + lineGap) * scale;
+
+    for (int i = 0; i < FONT_CHAR_COUNT; i++) {
+        const stbtt_bakedchar& baked = bakedChars[i];
+
+        font.glyphs[i] = {
+            .offset  = { baked.xoff, baked.yoff },
+            .size    = { (f32)(baked.x1 - baked.x0), (f32)(baked.y1 - baked.y0) },
+            .uv0     = { (f32)baked.x0 / FONT_ATLAS_SIZE, (f32)baked.y0 / FONT_ATLAS_SIZE },
+            .uv1     = { (f32)baked.x1 / FONT_ATLAS_SIZE, (f32)baked.y1 / FONT_ATLAS_SIZE },
+            .advance = baked.xadvance,
+        };
+    }
+
+    return true;
+}
+
+void Renderer2D::ShapeText(const Font& font, const char* text, TextRun& run) {
+    u64 hash = Util::HashBytes(Util::HASH_SEED, text, strlen(text));
+
+    if (run.font == &font && run.hash == hash) {
+        return;
+    }
+
+    run.font = &font;
+    run.hash = hash;
+    run.size = { 0.0f, font.lineHeight };
+    run.quads.Clear();
+
+    Vec2 pen = { 0.0f, font.ascent };
+
+    for (const char* c = text; *c && !run.quads.Full(); c++) {
+        if (*c == '\n') {
+            pen.x  = 0.0f;
+            pen.y += font.lineHeight;
+
+            run.size.y += font.lineHeight;
+            continue;
+        }
+
+        int index = (u8)*c - FONT_FIRST_CHAR;
+
+        if (index < 0 || index >= FONT_CHAR_COUNT) {
+            index = '?' - FONT_FIRST_CHAR;
+        }
+
+        const Glyph& glyph = font.glyphs[index];
+
+        if (glyph.size.x > 0 && glyph.size.y > 0) {
+            run.quads.Push({
+                .position = pen + glyph.offset,
+                .size     = glyph.size,
+                .uv0      = glyph.uv0,
+                .uv1      = glyph.uv1,
+            });
+        }
+
+        pen.x += glyph.advance;
+
+        if (pen.x > run.size.x) {
+            run.size.x = pen.x;
+        }
+    }
+}
+
+void Renderer2D::DrawTextRun(const TextRun& run, const Vec2& position, const Vec4& color) {
+    if (!run.font) {
+        return;
+    }
+
+    for (int i = 0; i < run.quads.Size(); i++) {
+        const GlyphQuad& quad = run.quads[i];
+        DrawTextureRegion(run.font->atlas, position + quad.position, quad.size, quad.uv0, quad.uv1, color);
+    }
+}
+
+static TextRun& CachedRun(const Font& font, const char* text) {
+    u64 hash = Util::HashBytes(Util::HASH_SEED, text, strlen(text));
+    TextRun& run = m_runCache[hash % TEXT_RUN_CACHE_SIZE];
+
+    ShapeText(font, text, run);
+
+    return run;
+}
+
+void Renderer2D::DrawText(const Font& font, const char* text, const Vec2& position, const Vec4& color) {
+    DrawTextRun(CachedRun(font, text), position, color);
+}
+
+Vec2 Renderer2D::MeasureText(const Font& font, const char* text) {
+    return CachedRun(font, text).size;
+}
@@ -0,0 +1,59 @@
+#ifndef CORE_RENDERER_FONT_H
+#define CORE_RENDERER_FONT_H
+
+#include "LinearMath.h"
+#include "List.h"
+#include "Texture.h"
+
+#define FONT_FIRST_CHAR 32
+#define FONT_CHAR_COUNT 96
+#define FONT_ATLAS_SIZE 512
+#define MAX_TEXT_RUN_LENGTH 128
+
+struct Glyph {
+    Vec2 offset;    // from the pen position on the baseline to the top left of the quad
+    Vec2 size;
+    Vec2 uv0;
+    Vec2 uv1;
+    f32 advance;
+};
+
+// printable ascii rasterised into a single atlas texture at load time
+struct Font {
+    Texture2D atlas;
+    f32 pixelHeight;
+    f32 ascent;
+    f32 lineHeight;
+    Glyph glyphs[FONT_CHAR_COUNT];
+};
+
+struct GlyphQuad {
+    Vec2 position;  // relative to the top left of the run
+    Vec2 size;
+    Vec2 uv0;
+    Vec2 uv1;
+};
+
+// a string laid out once into glyph quads, drawing it again only copies quads
+struct TextRun {
+    const Font* font;
+    u64 hash;
+    Vec2 size;
+    List<GlyphQuad, MAX_TEXT_RUN_LENGTH> quads;
+};
+
+namespace Renderer2D {
+
+bool LoadFont(Font& font, const char* filename, f32 pixelHeight);
+
+// lays out text into run, does nothing if run already holds the same text
+void ShapeText(const Font& font, const char* text, TextRun& run);
+void DrawTextRun(const TextRun& run, const Vec2& position, const Vec4& color);
+
+// shapes through a small cache of runs, so a label that does not change is never re-laid out
+void DrawText(const Font& font, const char* text, const Vec2& position, const Vec4& color);
+Vec2 MeasureText(const Font& font, const char* text);
+
+}
+
+#endif
@@ -0,0 +1,273 @@
+#include "Buffer.h"
+#include "GLState.h"
+#include "RenderBackend.h"
+#include "Shader.h"
+#include "core/Memory.h"
+#include "core/Util.h"
+
+#include <iostream>
+
+#include <glad/glad.h>
+
+using namespace Renderer2D;
+
+// vertices uploaded per draw call, bigger batches are drawn in several
+static constexpr usize QUAD_STREAM_VERTICES = 6 * 256;
+static constexpr usize LINE_STREAM_VERTICES = 2 * 256;
+
+#define MAX_GL_MESHES 512
+
+struct GLMesh {
+    Buffer vbo;
+    MeshType type;
+};
+
+/* QUAD PIPELINE */
+static Buffer m_quadVBO;
+
+// the same source specialised for a whole batch slot table, and for batches
+// (and meshes) that only sample one texture, which skips the slot branches
+static Shader m_quadShader;
+static Shader m_quadShaderSingle;
+static int m_quadProjection;
+static int m_quadSingleProjection;
+
+/* LINE PIPELINE */
+static Buffer m_lineVBO;
+static Shader m_lineShader;
+static int m_lineProjection;
+
+static Pool<GLMesh, MAX_GL_MESHES> m_meshes;
+
+// the attribute pointers already reference the buffer, nothing to bind
+static void DrawBuffer(u32 type, usize count, usize first = 0) {
+    glDrawArrays(type, first, count);
+}
+
+// sampler i always reads texture unit i, so the samplers are set once at init
+static void InitSamplers(const Shader& shader) {
+    const ShaderUniform* textures = FindUniform(shader, "u_textures");
+
+    if (!textures) {
+        return;
+    }
+
+    int units[MAX_TEXTURE_SLOTS];
+    int count = (textures->size < MAX_TEXTURE_SLOTS) ? textures->size : MAX_TEXTURE_SLOTS;
+
+    for (int i = 0; i < count; i++) {
+        units[i] = i;
+    }
+
+    SetUniformArray(shader, textures->location, units, count);
+}
+
+static void PushLineAttributes(Buffer& buffer) {
+    buffer.attributes.Push({ GL_FLOAT, 2, "a_position" });
+    buffer.attributes.Push({ GL_FLOAT, 4, "a_color" });
+}
+
+static void PushQuadAttributes(Buffer& buffer) {
+    buffer.attributes.Push({ GL_FLOAT, 2, "a_position" });
+    buffer.attributes.Push({ GL_FLOAT, 2, "a_textureCoord" });
+    buffer.attributes.Push({ GL_FLOAT, 4, "a_color" });
+    buffer.attributes.Push({ GL_FLOAT, 1, "a_textureID" });
+}
+
+static void Init(int viewportWidth, int viewportHeight) {
+    auto version  = (const char*)glGetString(GL_VERSION);
+    auto renderer = (const char*)glGetString(GL_RENDERER);
+    auto vendor   = (const char*)glGetString(GL_VENDOR);
+    auto shading  = (const char*)glGetString(GL_SHADING_LANGUAGE_VERSION);
+
+    std::cout << "GL Version:   " << version << std::endl;
+    std::cout << "Renderer:     " << renderer << std::endl;
+    std::cout << "Vendor:       " << vendor << std::endl;
+    std::cout << "GLSL Version: " << shading << std::endl;
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    m_quadVBO = CreateBuffer(sizeof(QuadVertex) * QUAD_STREAM_VERTICES);
+    PushQuadAttributes(m_quadVBO);
+
+    {
+        std::string vertexSource   = Util::ReadEntireFile("data/vertex.glsl");
+        std::string fragmentSource = Util::ReadEntireFile("data/frag.glsl");
+
+        ShaderDefines defines;
+
+        static_assert(MAX_TEXTURE_SLOTS <= 8, "frag.glsl samples at most 8 textures");
+
+        defines.Push({ "TEXTURE_SLOTS", MAX_TEXTURE_SLOTS });
+        m_quadShader = CreateShader(vertexSource, fragmentSource, m_quadVBO.attributes, defines);
+
+        defines.Clear();
+        defines.Push({ "TEXTURE_SLOTS", 1 });
+        m_quadShaderSingle = CreateShader(vertexSource, fragmentSource, m_quadVBO.attributes, defines);
+    }
+
+    InitSamplers(m_quadShader);
+    InitSamplers(m_quadShaderSingle);
+
+    m_lineVBO = CreateBuffer(sizeof(LineVertex) * LINE_STREAM_VERTICES);
+
+    PushLineAttributes(m_lineVBO);
+
+    {
+        std::string vertexSource   = Util::ReadEntireFile("data/line_vertex.glsl");
+        std::string fragmentSource = Util::ReadEntireFile("data/line_frag.glsl");
+
+        m_lineShader = CreateShader(vertexSource, fragmentSource, m_lineVBO.attributes);
+    }
+
+    m_quadProjection       = UniformLocation(m_quadShader, "u_projection");
+    m_quadSingleProjection = UniformLocation(m_quadShaderSingle, "u_projection");
+    m_lineProjection       = UniformLocation(m_lineShader, "u_projection");
+
+    glViewport(0, 0, viewportWidth, viewportHeight);
+}
+
+static void Shutdown() {
+    DestroyShader(m_lineShader);
+    DestroyShader(m_quadShaderSingle);
+    DestroyShader(m_quadShader);
+
+    DestroyBuffer(m_lineVBO);
+    DestroyBuffer(m_quadVBO);
+}
+
+static void SetViewport(int width, int height) {
+    glViewport(0, 0, width, height);
+}
+
+static void SetProjection(const Mat4& projection) {
+    SetUniform(m_quadShader, m_quadProjection, projection);
+    SetUniform(m_quadShaderSingle, m_quadSingleProjection, projection);
+    SetUniform(m_lineShader, m_lineProjection, projection);
+}
+
+static void Clear(const Vec4& color) {
+    glClearColor(color.x, color.y, color.z, color.w);
+    glClear(GL_COLOR_BUFFER_BIT);
+}
+
+static u32 CreateTexture(u32 width, u32 height, const void* pixels) {
+    u32 id = 0;
+    
+    glGenTextures(1, &id);
+    BindTexture(0, id);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+
+    return id;
+}
+
+static void DrawQuads(const QuadVertex* vertices, usize count, const u32* textures, usize textureCount) {
+    UseShader((textureCount == 1) ? m_quadShaderSingle : m_quadShader);
+    EnableAttributes(m_quadVBO);
+
+    for (usize i = 0; i < textureCount; i++) {
+        BindTexture(i, textures[i]);
+    }
+
+    for (usize first = 0; first < count; first += QUAD_STREAM_VERTICES) {
+        usize size = (count - first < QUAD_STREAM_VERTICES) ? count - first : QUAD_STREAM_VERTICES;
+
+        SetBufferData(m_quadVBO, sizeof(QuadVertex) * size, vertices + first);
+        DrawBuffer(GL_TRIANGLES, size);
+    }
+}
+
+static void DrawLines(const LineVertex* vertices, usize count) {
+    UseShader(m_lineShader);
+    EnableAttributes(m_lineVBO);
+
+    for (usize first = 0; first < count; first += LINE_STREAM_VERTICES) {
+        usize size = (count - first < LINE_STREAM_VERTICES) ? count - first : LINE_STREAM_VERTICES;
+
+        SetBufferData(m_lineVBO, sizeof(LineVertex) * size, vertices + first);
+        DrawBuffer(GL_LINES, size);
+    }
+}
+
+// handles are pool index + 1, so 0 is never a valid mesh
+static GLMesh* GetMesh(u32 mesh) {
+    ASSERT(mesh != 0);
+    return m_meshes.Get(mesh - 1);
+}
+
+static u32 CreateMesh(MeshType type, usize capacity, BufferUsage usage) {
+    usize vertexSize = (type == MESH_QUADS) ? sizeof(QuadVertex) : sizeof(LineVertex);
+
+    GLMesh* mesh = m_meshes.Create();
+    mesh->type = type;
+    mesh->vbo  = CreateBuffer(vertexSize * capacity, usage);
+
+    if (type == MESH_QUADS) {
+        PushQuadAttributes(mesh->vbo);
+    }
+    else {
+        PushLineAttributes(mesh->vbo);
+    }
+
+    return m_meshes.IndexOf(mesh) + 1;
+}
+
+static void DestroyMesh(u32 handle) {
+    GLMesh* mesh = GetMesh(handle);
+
+    DestroyBuffer(mesh->vbo);
+    m_meshes.Destroy(mesh);
+}
+
+static void SetMeshData(u32 handle, const void* vertices, usize count) {
+    GLMesh* mesh = GetMesh(handle);
+    usize vertexSize = (mesh->type == MESH_QUADS) ? sizeof(QuadVertex) : sizeof(LineVertex);
+
+    SetBufferData(mesh->vbo, vertexSize * count, vertices);
+}
+
+static void DrawMesh(u32 handle, usize first, usize count, u32 texture) {
+    GLMesh* mesh = GetMesh(handle);
+
+    if (mesh->type == MESH_QUADS) {
+        UseShader(m_quadShaderSingle);
+        EnableAttributes(mesh->vbo);
+        BindTexture(0, texture);
+
+        DrawBuffer(GL_TRIANGLES, count, first);
+    }
+    else {
+        UseShader(m_lineShader);
+        EnableAttributes(mesh->vbo);
+
+        DrawBuffer(GL_LINES, count, first);
+    }
+}
+
+const RenderBackend& Renderer2D::GLBackend() {
+    static const RenderBackend backend = {
+        .name            = "OpenGL ES 2",
+        .init            = Init,
+        .shutdown        = Shutdown,
+        .invalidateState = InvalidateGLState,
+        .setViewport     = SetViewport,
+        .setProjection   = SetProjection,
+        .clear           = Clear,
+        .createTexture   = CreateTexture,
+        .drawQuads       = DrawQuads,
+        .drawLines       = DrawLines,
+        .createMesh      = CreateMesh,
+        .destroyMesh     = DestroyMesh,
+        .setMeshData     = SetMeshData,
+        .drawMesh        = DrawMesh,
+    };
+
+    return backend;
+}
@@ -0,0 +1,108 @@
+#include "GLState.h"
+
+#include <glad/glad.h>
+
+// 0xFFFFFFFF never matches a real name, so the next call always goes through
+static constexpr u32 UNKNOWN = 0xFFFFFFFF;
+
+static u32 m_program       = UNKNOWN;
+static u32 m_arrayBuffer   = UNKNOWN;
+static u32 m_activeUnit    = UNKNOWN;
+static u32 m_attributeMask = UNKNOWN;
+static u32 m_attributeBuffer = UNKNOWN;
+
+static_assert(Renderer2D::MAX_TEXTURE_SLOTS == 8, "one UNKNOWN per texture slot");
+
+static u32 m_textures[Renderer2D::MAX_TEXTURE_SLOTS] = {
+    UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN,
+};
+
+void Renderer2D::UseProgram(u32 program) {
+    if (m_program != program) {
+        glUseProgram(program);
+        m_program = program;
+    }
+}
+
+void Renderer2D::BindArrayBuffer(u32 buffer) {
+    if (m_arrayBuffer != buffer) {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        m_arrayBuffer = buffer;
+    }
+}
+
+void Renderer2D::BindTexture(u32 unit, u32 texture) {
+    ASSERT(unit < MAX_TEXTURE_SLOTS);
+
+    if (m_textures[unit] == texture) {
+        return;
+    }
+
+    if (m_activeUnit != unit) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        m_activeUnit = unit;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, texture);
+    m_textures[unit] = texture;
+}
+
+void Renderer2D::SetEnabledAttributes(u32 mask) {
+    if (m_attributeMask == mask) {
+        return;
+    }
+
+    // unknown state, touch every attribute once
+    u32 changed = (m_attributeMask == UNKNOWN) ? 0xFF : (m_attributeMask ^ mask);
+
+    for (u32 i = 0; changed; i++, changed >>= 1) {
+        if (!(changed & 1)) {
+            continue;
+        }
+
+        if (mask & (1 << i)) {
+            glEnableVertexAttribArray(i);
+        }
+        else {
+            glDisableVertexAttribArray(i);
+        }
+    }
+
+    m_attributeMask = mask;
+}
+
+u32 Renderer2D::AttributeBuffer() {
+    return m_attributeBuffer;
+}
+
+void Renderer2D::SetAttributeBuffer(u32 buffer) {
+    m_attributeBuffer = buffer;
+}
+
+void Renderer2D::InvalidateGLState() {
+    m_program         = UNKNOWN;
+    m_arrayBuffer     = UNKNOWN;
+    m_activeUnit      = UNKNOWN;
+    m_attributeMask   = UNKNOWN;
+    m_attributeBuffer = UNKNOWN;
+
+    for (int i = 0; i < MAX_TEXTURE_SLOTS; i++) {
+        m_textures[i] = UNKNOWN;
+    }
+}
+
+void Renderer2D::ForgetProgram(u32 program) {
+    if (m_program == program) {
+        m_program = UNKNOWN;
+    }
+}
+
+void Renderer2D::ForgetBuffer(u32 buffer) {
+    if (m_arrayBuffer == buffer) {
+        m_arrayBuffer = UNKNOWN;
+    }
+
+    if (m_attributeBuffer == buffer) {
+        m_attributeBuffer = UNKNOWN;
+    }
+}
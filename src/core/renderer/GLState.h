@@ -0,0 +1,33 @@
+#ifndef CORE_RENDERER_GL_STATE_H
+#define CORE_RENDERER_GL_STATE_H
+
+#include "Basic.h"
+#include "RenderBackend.h"
+
+namespace Renderer2D {
+
+// shadows the bits of gl state the renderer changes, calls that would not
+// change anything never reach the driver. all renderer code binds through
+// these instead of calling gl directly
+
+void UseProgram(u32 program);
+void BindArrayBuffer(u32 buffer);
+void BindTexture(u32 unit, u32 texture);
+
+// enables the vertex attributes whose bit is set and disables the rest
+void SetEnabledAttributes(u32 mask);
+
+// the buffer whose layout the vertex attribute pointers currently describe
+u32 AttributeBuffer();
+void SetAttributeBuffer(u32 buffer);
+
+// forgets everything, for after code outside the renderer (imgui) touched gl
+void InvalidateGLState();
+
+// a deleted object can get its name reused, so the cache must not keep it
+void ForgetProgram(u32 program);
+void ForgetBuffer(u32 buffer);
+
+}
+
+#endif
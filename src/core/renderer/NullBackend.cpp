@@ -0,0 +1,149 @@
+#include "NullBackend.h"
+#include "RenderBackend.h"
+#include "core/Memory.h"
+
+#include <iostream>
+
+using namespace Renderer2D;
+
+#define MAX_NULL_MESHES 512
+
+struct NullMesh {
+    MeshType type;
+};
+
+static RenderStats m_frameStats;
+static RenderStats m_totalStats;
+
+// what the gl state cache would hold, so binds are only counted when gl would issue them
+static u32 m_boundTextures[MAX_TEXTURE_SLOTS];
+
+static u32 m_textureCount;
+static Pool<NullMesh, MAX_NULL_MESHES> m_meshes;
+
+static usize VertexSize(MeshType type) {
+    return (type == MESH_QUADS) ? sizeof(QuadVertex) : sizeof(LineVertex);
+}
+
+static void BindTexture(u32 unit, u32 texture) {
+    ASSERT(unit < MAX_TEXTURE_SLOTS);
+
+    if (m_boundTextures[unit] != texture) {
+        m_boundTextures[unit] = texture;
+        m_frameStats.textureBinds += 1;
+    }
+}
+
+static void Init(int viewportWidth, int viewportHeight) {
+    std::cout << "Renderer:     null" << std::endl;
+
+    m_frameStats = {};
+    m_totalStats = {};
+}
+
+static void Shutdown() {
+    m_textureCount = 0;
+}
+
+static void InvalidateState() {
+    for (u32 i = 0; i < MAX_TEXTURE_SLOTS; i++) {
+        m_boundTextures[i] = 0;
+    }
+}
+
+static void EndFrame() {
+    m_totalStats.frames        += 1;
+    m_totalStats.drawCalls     += m_frameStats.drawCalls;
+    m_totalStats.vertices      += m_frameStats.vertices;
+    m_totalStats.textureBinds  += m_frameStats.textureBinds;
+    m_totalStats.bytesUploaded += m_frameStats.bytesUploaded;
+
+    m_frameStats = {};
+}
+
+static void SetViewport(int width, int height) {}
+static void SetProjection(const Mat4& projection) {}
+static void Clear(const Vec4& color) {}
+
+static u32 CreateTexture(u32 width, u32 height, const void* pixels) {
+    m_frameStats.bytesUploaded += (u64)width * height * sizeof(u32);
+
+    m_textureCount += 1;
+    return m_textureCount;
+}
+
+static void DrawQuads(const QuadVertex* vertices, usize count, const u32* textures, usize textureCount) {
+    for (usize i = 0; i < textureCount; i++) {
+        BindTexture(i, textures[i]);
+    }
+
+    m_frameStats.drawCalls     += 1;
+    m_frameStats.vertices      += count;
+    m_frameStats.bytesUploaded += count * sizeof(QuadVertex);
+}
+
+static void DrawLines(const LineVertex* vertices, usize count) {
+    m_frameStats.drawCalls     += 1;
+    m_frameStats.vertices      += count;
+    m_frameStats.bytesUploaded += count * sizeof(LineVertex);
+}
+
+// handles are pool index + 1, so 0 is never a valid mesh
+static NullMesh* GetMesh(u32 mesh) {
+    ASSERT(mesh != 0);
+    return m_meshes.Get(mesh - 1);
+}
+
+static u32 CreateMesh(MeshType type, usize capacity, BufferUsage usage) {
+    NullMesh* mesh = m_meshes.Create();
+    mesh->type = type;
+
+    return m_meshes.IndexOf(mesh) + 1;
+}
+
+static void DestroyMesh(u32 handle) {
+    m_meshes.Destroy(GetMesh(handle));
+}
+
+static void SetMeshData(u32 handle, const void* vertices, usize count) {
+    m_frameStats.bytesUploaded += count * VertexSize(GetMesh(handle)->type);
+}
+
+static void DrawMesh(u32 handle, usize first, usize count, u32 texture) {
+    if (GetMesh(handle)->type == MESH_QUADS) {
+        BindTexture(0, texture);
+    }
+
+    m_frameStats.drawCalls += 1;
+    m_frameStats.vertices  += count;
+}
+
+const RenderBackend& Renderer2D::NullBackend() {
+    static const RenderBackend backend = {
+        .name            = "Null",
+        .init            = Init,
+        .shutdown        = Shutdown,
+        .invalidateState = InvalidateState,
+        .endFrame        = EndFrame,
+        .setViewport     = SetViewport,
+        .setProjection   = SetProjection,
+        .clear           = Clear,
+        .createTexture   = CreateTexture,
+        .drawQuads       = DrawQuads,
+        .drawLines       = DrawLines,
+        .createMesh      = CreateMesh,
+        .destroyMesh     = DestroyMesh,
+        .setMeshData     = SetMeshData,
+        .drawMesh        = DrawMesh,
+    };
+
+    return backend;
+}
+
+const RenderStats& Renderer2D::NullFrameStats() {
+    return m_frameStats;
+}
+
+const RenderStats& Renderer2D::NullTotalStats() {
+    return m_totalStats;
+}
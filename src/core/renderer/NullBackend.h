@@ -0,0 +1,23 @@
+#ifndef CORE_RENDERER_NULL_BACKEND_H
+#define CORE_RENDERER_NULL_BACKEND_H
+
+#include "Basic.h"
+
+// what the gl backend would have been asked to do, counted by the null
+// backend. everything up to the backend runs as normal, so this measures
+// the cpu side of submission without any driver cost
+struct RenderStats {
+    u64 frames;
+    u64 drawCalls;
+    u64 vertices;
+    u64 textureBinds;
+    u64 bytesUploaded;
+};
+
+namespace Renderer2D {
+    // the frame in progress and everything since init, EndFrame moves one into the other
+    const RenderStats& NullFrameStats();
+    const RenderStats& NullTotalStats();
+}
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef CORE_RENDERER_RENDER_BACKEND_H
+#define CORE_RENDERER_RENDER_BACKEND_H
+
+#include "Buffer.h"
+#include "LinearMath.h"
+#include "Vertex.h"
+
+namespace Renderer2D {
+
+enum RenderBackendType {
+    RENDER_BACKEND_GL,       // GLES2 through glad, needs a current context
+    RENDER_BACKEND_SOFTWARE, // rasterizes into a framebuffer in memory
+    RENDER_BACKEND_NULL,     // draws nothing, counts what would have been drawn
+};
+
+// textures one quad batch can sample, the GL backend's shader has this many samplers
+inline constexpr int MAX_TEXTURE_SLOTS = 8;
+
+enum MeshType {
+    MESH_QUADS, // QuadVertex triangle list
+    MESH_LINES, // LineVertex line list
+};
+
+// the device side of the renderer. Renderer2D.cpp does all the batching and
+// hands finished batches to the backend, which owns every device object.
+// textures and meshes are referred to by non zero handles
+struct RenderBackend {
+    const char* name;
+
+    void (*init)(int viewportWidth, int viewportHeight);
+    void (*shutdown)();
+
+    // forget cached device state, something else may have changed it
+    void (*invalidateState)();
+
+    // optional, called once at the end of every frame
+    void (*endFrame)();
+
+    void (*setViewport)(int width, int height);
+    void (*setProjection)(const Mat4& projection);
+    void (*clear)(const Vec4& color);
+
+    // pixels are RGBA8, rows top to bottom
+    u32 (*createTexture)(u32 width, u32 height, const void* pixels);
+
+    // vertex i samples textures[vertex.textureID], at most MAX_TEXTURE_SLOTS of them
+    void (*drawQuads)(const QuadVertex* vertices, usize count, const u32* textures, usize textureCount);
+    void (*drawLines)(const LineVertex* vertices, usize count);
+
+    u32 (*createMesh)(MeshType type, usize capacity, BufferUsage usage);
+    void (*destroyMesh)(u32 mesh);
+    void (*setMeshData)(u32 mesh, const void* vertices, usize count);
+
+    // quad meshes sample texture for every vertex, line meshes ignore it
+    void (*drawMesh)(u32 mesh, usize first, usize count, u32 texture);
+};
+
+const RenderBackend& GLBackend();
+const RenderBackend& SoftwareBackend();
+const RenderBackend& NullBackend();
+
+}
+
+#endif
@@ -1,54 +1,36 @@
-#include "Buffer.h"
 #include "LinearMath.h"
+#include "core/Memory.h"
+#include "RenderBackend.h"
 #include "Renderer2D.h"
-#include "Shader.h"
-#include "core/Util.h"
-
-#include <iostream>
-
-#include <glad/glad.h>
+#include "Vertex.h"
 
 using namespace Renderer2D;
 
-static constexpr int MAX_BATCH_SIZE    = 256;
-static constexpr int MAX_ATTRIBUTES    = 8;
-static constexpr int MAX_TEXTURE_COUNT = 8;
+static constexpr int MAX_BATCH_SIZE = 256;
 
 static constexpr int VERTICES_PER_QUAD = 6;
 static constexpr int VERTICES_PER_LINE = 2;
 
-struct QuadVertex {
-    Vec2 position;
-    Vec2 textureCoord;
-    Vec4 color;
-    f32 textureID;
-};
-
-struct LineVertex {
-    Vec2 position;
-    Vec4 color;
-};
-
-/* QUAD PIPELINE */
-static Buffer m_quadVBO;
-static u32 m_quadShader;
+static constexpr int MAX_PENDING_BATCHES = 64;
+
+static const RenderBackend* m_backend;
+
+/* QUAD BATCH */
 static List<QuadVertex, VERTICES_PER_QUAD * MAX_BATCH_SIZE> m_quadVertexBuffer;
 
 static Texture2D m_whiteTexture;
-static List<Texture2D, MAX_TEXTURE_COUNT> m_textureSlots;
+static List<Texture2D, MAX_TEXTURE_SLOTS> m_textureSlots;
 
-/* LINE PIPELINE */
-static Buffer m_lineVBO;
-static u32 m_lineShader;
+/* LINE BATCH */
 static List<LineVertex, VERTICES_PER_LINE * MAX_BATCH_SIZE> m_lineVertexBuffer;
 
+/* PARALLEL BATCHES */
+static List<const BatchBuilder*, MAX_PENDING_BATCHES> m_pendingBatches;
+
 /* MISC */
-static Mat4 m_projection;
+static Vec2 m_viewportSize;
 
-static void DrawBuffer(const Buffer& buffer, u32 type, usize count) {
-    glBindBuffer(GL_ARRAY_BUFFER, buffer.renderID);
-    glDrawArrays(type, 0, count);
-}
+static void Flush();
 
 static int GetTextureSlot(const Texture2D& texture) {
     int index = -1;
@@ -61,6 +43,11 @@ static int GetTextureSlot(const Texture2D& texture) {
     }
 
     if (index == -1) {
+        // out of slots, the texture starts a new batch
+        if (m_textureSlots.Full()) {
+            Flush();
+        }
+
         index = m_textureSlots.Size();
         m_textureSlots.Push(texture);
     }
@@ -68,106 +55,146 @@ static int GetTextureSlot(const Texture2D& texture) {
     return index;
 }
 
-static void Flush() {
-    if (!m_quadVertexBuffer.Empty()) {
-        UseShader(m_quadShader);
-        EnableAttributes(m_quadVBO);
+// two triangles over the corners returned by TransformQuad
+static void ExpandQuad(const Mat3x2& matrix, const Vec4& color, f32 textureSlot, QuadVertex* vertices) {
+    static constexpr int quadIndices[] = { 0, 1, 2, 2, 3, 0 };
 
-        for (int i = 0; i < m_textureSlots.Size(); i++) {
-            glActiveTexture(GL_TEXTURE0 + i);
-            glBindTexture(GL_TEXTURE_2D, m_textureSlots[i].renderID);
+    static constexpr Vec2 quadTextureCoords[] = {
+        { 0, 0 },
+        { 1, 0 },
+        { 1, 1 },
+        { 0, 1 },
+    };
 
-            SetUniformIndex(m_quadShader, i, i, "u_textures");
-        }
+    Vec2 corners[4];
+    TransformQuad(matrix, corners);
 
-        SetBufferData(m_quadVBO, sizeof(QuadVertex) * m_quadVertexBuffer.Size(), m_quadVertexBuffer.Data());
-        DrawBuffer(m_quadVBO, GL_TRIANGLES, m_quadVertexBuffer.Size());
+    for (int i = 0; i < VERTICES_PER_QUAD; i++) {
+        int corner = quadIndices[i];
 
-        m_textureSlots.Clear();
-        m_quadVertexBuffer.Clear();
+        vertices[i] = {
+            .position     = corners[corner],
+            .textureCoord = quadTextureCoords[corner],
+            .color        = color,
+            .textureID    = (f32)textureSlot,
+        };
     }
+}
 
-    if (!m_lineVertexBuffer.Empty()) {
-        UseShader(m_lineShader);
-        EnableAttributes(m_lineVBO);
+// the builders only know textures, slots are assigned here in submission order
+static void MergePendingBatches() {
+    for (usize b = 0; b < m_pendingBatches.Size(); b++) {
+        const BatchBuilder& builder = *m_pendingBatches[b];
 
-        SetBufferData(m_lineVBO, sizeof(LineVertex) * m_lineVertexBuffer.Size(), m_lineVertexBuffer.Data());
-        DrawBuffer(m_lineVBO, GL_LINES, m_lineVertexBuffer.Size());
+        for (usize q = 0; q < builder.textures.Size(); q++) {
+            if (m_quadVertexBuffer.Full()) {
+                Flush();
+            }
 
-        m_lineVertexBuffer.Clear();
-    }
-}
+            f32 textureSlot = (f32)GetTextureSlot(builder.textures[q]);
+            const QuadVertex* source = &builder.vertices[q * VERTICES_PER_QUAD];
 
-void Renderer2D::Init() {
-    auto version  = (const char*)glGetString(GL_VERSION);
-    auto renderer = (const char*)glGetString(GL_RENDERER);
-    auto vendor   = (const char*)glGetString(GL_VENDOR);
-    auto shading  = (const char*)glGetString(GL_SHADING_LANGUAGE_VERSION);
+            for (int i = 0; i < VERTICES_PER_QUAD; i++) {
+                QuadVertex vertex = source[i];
+                vertex.textureID = textureSlot;
 
-    std::cout << "GL Version:   " << version << std::endl;
-    std::cout << "Renderer:     " << renderer << std::endl;
-    std::cout << "Vendor:       " << vendor << std::endl;
-    std::cout << "GLSL Version: " << shading << std::endl;
+                m_quadVertexBuffer.Push(vertex);
+            }
+        }
+    }
 
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    m_pendingBatches.Clear();
+}
 
-    m_quadVBO = CreateBuffer(sizeof(QuadVertex) * m_quadVertexBuffer.Capacity());
+static void Flush() {
+    if (!m_quadVertexBuffer.Empty()) {
+        u32 textures[MAX_TEXTURE_SLOTS];
 
-    m_quadVBO.attributes.Push({ GL_FLOAT, 2, "a_position" });
-    m_quadVBO.attributes.Push({ GL_FLOAT, 2, "a_textureCoord" });
-    m_quadVBO.attributes.Push({ GL_FLOAT, 4, "a_color" });
-    m_quadVBO.attributes.Push({ GL_FLOAT, 1, "a_textureID" });
+        for (int i = 0; i < m_textureSlots.Size(); i++) {
+            textures[i] = m_textureSlots[i].renderID;
+        }
 
-    {
-        std::string vertexSource   = Util::ReadEntireFile("data/vertex.glsl");
-        std::string fragmentSource = Util::ReadEntireFile("data/frag.glsl");
+        m_backend->drawQuads(m_quadVertexBuffer.Data(), m_quadVertexBuffer.Size(), textures, m_textureSlots.Size());
 
-        m_quadShader = CreateShader(vertexSource, fragmentSource, m_quadVBO.attributes);
+        m_textureSlots.Clear();
+        m_quadVertexBuffer.Clear();
     }
 
-    m_lineVBO = CreateBuffer(sizeof(LineVertex) * m_lineVertexBuffer.Capacity());
+    if (!m_lineVertexBuffer.Empty()) {
+        m_backend->drawLines(m_lineVertexBuffer.Data(), m_lineVertexBuffer.Size());
+        m_lineVertexBuffer.Clear();
+    }
+}
 
-    m_lineVBO.attributes.Push({ GL_FLOAT, 2, "a_position" });
-    m_lineVBO.attributes.Push({ GL_FLOAT, 4, "a_color" });
+static const RenderBackend& GetBackend(RenderBackendType type) {
+    switch (type) {
+        case RENDER_BACKEND_GL:       return GLBackend();
+        case RENDER_BACKEND_SOFTWARE: return SoftwareBackend();
+        case RENDER_BACKEND_NULL:     return NullBackend();
+    }
 
-    {
-        std::string vertexSource   = Util::ReadEntireFile("data/line_vertex.glsl");
-        std::string fragmentSource = Util::ReadEntireFile("data/line_frag.glsl");
+    ASSERT(false);
+    return GLBackend();
+}
 
-        m_lineShader = CreateShader(vertexSource, fragmentSource, m_lineVBO.attributes);
-    }
+void Renderer2D::Init(int viewportWidth, int viewportHeight, RenderBackendType backend) {
+    m_backend = &GetBackend(backend);
+    m_backend->init(viewportWidth, viewportHeight);
 
     u32 whitePixels[] = { 0xFFFFFFFF };
     m_whiteTexture = CreateTexture(1, 1, whitePixels);
 
-    //TODO: hard coded
-    m_projection = OrthoProjection(0, 1280, 720, 0, 0, 1);
+    SetViewport(viewportWidth, viewportHeight);
+}
+
+void Renderer2D::InvalidateState() {
+    m_backend->invalidateState();
+}
+
+void Renderer2D::EndFrame() {
+    if (m_backend->endFrame) {
+        m_backend->endFrame();
+    }
 }
 
 void Renderer2D::Shutdown() {
-    DestroyShader(m_lineShader);
-    DestroyShader(m_quadShader);
+    m_backend->shutdown();
+}
+
+const RenderBackend& Renderer2D::Backend() {
+    ASSERT(m_backend);
+    return *m_backend;
+}
 
-    DestroyBuffer(m_lineVBO);
-    DestroyBuffer(m_quadVBO);
+void Renderer2D::SetViewport(int width, int height) {
+    m_viewportSize = { (f32)width, (f32)height };
+    m_backend->setViewport(width, height);
+}
+
+Vec2 Renderer2D::ViewportSize() {
+    return m_viewportSize;
 }
 
 void Renderer2D::Begin() {
-    SetUniform(m_quadShader, m_projection, "u_projection");
-    SetUniform(m_lineShader, m_projection, "u_projection");
+    Begin({ .viewportSize = m_viewportSize });
+}
+
+void Renderer2D::Begin(const Camera2D& camera) {
+    m_backend->setProjection(camera.Projection());
 }
 
 void Renderer2D::End() {
+    MergePendingBatches();
     Flush();
 }
 
 void Renderer2D::Clear(const Vec4& color) {
-    glClearColor(color.x, color.y, color.z, color.w);
-    glClear(GL_COLOR_BUFFER_BIT);
+    m_backend->clear(color);
 }
 
 void Renderer2D::DrawLine(const Vec2& start, const Vec2& end, const Vec4& color) {
+    MergePendingBatches();
+
     if (m_lineVertexBuffer.Full()) {
         Flush();
     }
@@ -198,12 +225,17 @@ void Renderer2D::DrawRectLines(const Vec2& position, const Vec2& size, const Vec
 }
 
 void Renderer2D::DrawRectLines(const Transform& transform, const Vec4& color) {
-    Mat4 transformMatrix = transform.Matrix();
+    DrawRectLines(transform.Matrix2D(), color);
+}
+
+void Renderer2D::DrawRectLines(const Mat3x2& matrix, const Vec4& color) {
+    Vec2 corners[4];
+    TransformQuad(matrix, corners);
 
-    Vec2 tl = transformMatrix * Vec2{ -0.5,  0.5 };
-    Vec2 tr = transformMatrix * Vec2{  0.5,  0.5 };
-    Vec2 bl = transformMatrix * Vec2{ -0.5, -0.5 };
-    Vec2 br = transformMatrix * Vec2{  0.5, -0.5 };
+    const Vec2& bl = corners[0];
+    const Vec2& br = corners[1];
+    const Vec2& tr = corners[2];
+    const Vec2& tl = corners[3];
 
     DrawLine(tl, tr, color); // top
     DrawLine(tr, br, color); // right
@@ -216,42 +248,141 @@ void Renderer2D::DrawTexture(const Texture2D& texture, const Vec2& position, con
 }
 
 void Renderer2D::DrawTexture(const Texture2D& texture, const Transform& transform, const Vec4& color) {
+    DrawTexture(texture, transform.Matrix2D(), color);
+}
+
+void Renderer2D::DrawTexture(const Texture2D& texture, const Mat3x2& matrix, const Vec4& color) {
+    MergePendingBatches();
+
     if (m_quadVertexBuffer.Full()) {
         Flush();
     }
 
-    static constexpr Vec4 quadVertices[] = {
-        { -0.5f, -0.5f, 0.0f, 1.0f },
-        {  0.5f, -0.5f, 0.0f, 1.0f },
-        {  0.5f,  0.5f, 0.0f, 1.0f },
+    int textureSlot = GetTextureSlot(texture);
+
+    m_quadVertexBuffer.Grow(VERTICES_PER_QUAD);
+    ExpandQuad(matrix, color, (f32)textureSlot, &m_quadVertexBuffer[m_quadVertexBuffer.Size() - VERTICES_PER_QUAD]);
+}
+
+void Renderer2D::DrawTextureRegion(const Texture2D& texture, const Vec2& position, const Vec2& size, const Vec2& uv0, const Vec2& uv1, const Vec4& color) {
+    MergePendingBatches();
+
+    if (m_quadVertexBuffer.Full()) {
+        Flush();
+    }
+
+    f32 textureSlot = (f32)GetTextureSlot(texture);
+
+    Vec2 p0 = position;
+    Vec2 p1 = position + size;
+
+    QuadVertex tl = { { p0.x, p0.y }, { uv0.x, uv0.y }, color, textureSlot };
+    QuadVertex tr = { { p1.x, p0.y }, { uv1.x, uv0.y }, color, textureSlot };
+    QuadVertex br = { { p1.x, p1.y }, { uv1.x, uv1.y }, color, textureSlot };
+    QuadVertex bl = { { p0.x, p1.y }, { uv0.x, uv1.y }, color, textureSlot };
+
+    m_quadVertexBuffer.Push(tl);
+    m_quadVertexBuffer.Push(tr);
+    m_quadVertexBuffer.Push(br);
 
-        {  0.5f,  0.5f, 0.0f, 1.0f },
-        { -0.5f,  0.5f, 0.0f, 1.0f },
-        { -0.5f, -0.5f, 0.0f, 1.0f },
+    m_quadVertexBuffer.Push(br);
+    m_quadVertexBuffer.Push(bl);
+    m_quadVertexBuffer.Push(tl);
+}
+
+Renderer2D::BatchBuilder Renderer2D::CreateBatchBuilder(usize quadCapacity) {
+    Arena& arena = Memory::FrameArena();
+
+    return {
+        .vertices = ArenaList<QuadVertex>(arena, quadCapacity * VERTICES_PER_QUAD),
+        .textures = ArenaList<Texture2D>(arena, quadCapacity),
     };
+}
 
-    static constexpr Vec2 quadTextureCoords[] = {
-        { 0, 0 },
-        { 1, 0 },
-        { 1, 1 },
+void Renderer2D::BatchTexture(BatchBuilder& builder, const Texture2D& texture, const Mat3x2& matrix, const Vec4& color) {
+    usize first = builder.vertices.Size();
+    builder.vertices.Grow(VERTICES_PER_QUAD);
 
-        { 1, 1 },
-        { 0, 1 },
-        { 0, 0 },
+    ExpandQuad(matrix, color, 0.0f, &builder.vertices[first]);
+    builder.textures.Push(texture);
+}
+
+void Renderer2D::SubmitBatch(const BatchBuilder& builder) {
+    if (m_pendingBatches.Full()) {
+        MergePendingBatches();
+    }
+
+    m_pendingBatches.Push(&builder);
+}
+
+Renderer2D::QuadMesh Renderer2D::CreateQuadMesh(usize capacity) {
+    return {
+        .handle      = m_backend->createMesh(MESH_QUADS, capacity, BUFFER_STATIC),
+        .capacity    = capacity,
+        .vertexCount = 0,
     };
+}
 
-    int textureSlot = GetTextureSlot(texture);
+void Renderer2D::DestroyQuadMesh(QuadMesh& mesh) {
+    m_backend->destroyMesh(mesh.handle);
 
-    for (int i = 0; i < VERTICES_PER_QUAD; i++) {
-        Vec4 transformVertex = transform.Matrix() * quadVertices[i];
+    mesh.handle      = 0;
+    mesh.capacity    = 0;
+    mesh.vertexCount = 0;
+}
 
-        QuadVertex vertex = {
-            .position     = { transformVertex.x, transformVertex.y },
-            .textureCoord = quadTextureCoords[i],
-            .color        = color,
-            .textureID    = (f32)textureSlot,
-        };
+void Renderer2D::SetQuadMeshData(QuadMesh& mesh, const QuadVertex* vertices, usize count) {
+    ASSERT(count <= mesh.capacity);
+
+    m_backend->setMeshData(mesh.handle, vertices, count);
+    mesh.vertexCount = count;
+}
+
+void Renderer2D::DrawQuadMesh(const QuadMesh& mesh, const Texture2D& texture) {
+    if (mesh.vertexCount == 0) {
+        return;
+    }
+
+    // anything batched so far was submitted first, so it is drawn first
+    MergePendingBatches();
+    Flush();
 
-        m_quadVertexBuffer.Push(vertex);
+    m_backend->drawMesh(mesh.handle, 0, mesh.vertexCount, texture.renderID);
+}
+
+Renderer2D::LineMesh Renderer2D::CreateLineMesh(usize capacity, BufferUsage usage) {
+    return {
+        .handle      = m_backend->createMesh(MESH_LINES, capacity, usage),
+        .capacity    = capacity,
+        .vertexCount = 0,
+    };
+}
+
+void Renderer2D::DestroyLineMesh(LineMesh& mesh) {
+    m_backend->destroyMesh(mesh.handle);
+
+    mesh.handle      = 0;
+    mesh.capacity    = 0;
+    mesh.vertexCount = 0;
+}
+
+void Renderer2D::SetLineMeshData(LineMesh& mesh, const LineVertex* vertices, usize count) {
+    ASSERT(count <= mesh.capacity);
+
+    m_backend->setMeshData(mesh.handle, vertices, count);
+    mesh.vertexCount = count;
+}
+
+void Renderer2D::DrawLineMesh(const LineMesh& mesh, usize first, usize count) {
+    ASSERT(first + count <= mesh.vertexCount);
+
+    if (count == 0) {
+        return;
     }
+
+    // anything batched so far was submitted first, so it is drawn first
+    MergePendingBatches();
+    Flush();
+
+    m_backend->drawMesh(mesh.handle, first, count, 0);
 }
\ No newline at end of file
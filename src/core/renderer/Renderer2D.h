@@ -1,8 +1,12 @@
 #ifndef CORE_RENDERER_H
 #define CORE_RENDERER_H
 
+#include "Buffer.h"
+#include "Camera.h"
 #include "LinearMath.h"
+#include "RenderBackend.h"
 #include "Texture.h"
+#include "Vertex.h"
 
 inline constexpr Vec4 WHITE = { 1, 1, 1, 1};
 inline constexpr Vec4 BLACK = { 0, 0, 0, 1};
@@ -11,10 +15,39 @@ inline constexpr Vec4 GREEN = { 0, 1, 0, 1};
 inline constexpr Vec4 BLUE  = { 0, 0, 1, 1};
 
 namespace Renderer2D {
-    void Init();
+    // static quad geometry owned by the backend, built once and drawn with a single call
+    struct QuadMesh {
+        u32 handle;
+        usize capacity;
+        usize vertexCount;
+    };
+
+    // line geometry owned by the backend
+    struct LineMesh {
+        u32 handle;
+        usize capacity;
+        usize vertexCount;
+    };
+
+    // the backend can not be changed after init
+    void Init(int viewportWidth, int viewportHeight, RenderBackendType backend = RENDER_BACKEND_GL);
     void Shutdown();
 
+    const RenderBackend& Backend();
+
+    // must be called after anything outside the renderer changed gl state
+    void InvalidateState();
+
+    // called by the application once the frame is fully submitted
+    void EndFrame();
+
+    // must be called whenever the window is resized
+    void SetViewport(int width, int height);
+    Vec2 ViewportSize();
+
+    // Begin() draws in screen space, Begin(camera) through the camera
     void Begin();
+    void Begin(const Camera2D& camera);
     void End();
 
     void Clear(const Vec4& color);
@@ -26,9 +59,45 @@ namespace Renderer2D {
 
     void DrawRectLines(const Vec2& position, const Vec2& size, const Vec4& color);
     void DrawRectLines(const Transform& transform, const Vec4& color);
+    void DrawRectLines(const Mat3x2& matrix, const Vec4& color);
 
     void DrawTexture(const Texture2D& texture, const Vec2& position, const Vec2& size, const Vec4& color);
     void DrawTexture(const Texture2D& texture, const Transform& transform, const Vec4& color);
+    void DrawTexture(const Texture2D& texture, const Mat3x2& matrix, const Vec4& color);
+
+    // axis aligned quad with its top left corner at position, sampling [uv0, uv1] of texture
+    void DrawTextureRegion(const Texture2D& texture, const Vec2& position, const Vec2& size, const Vec2& uv0, const Vec2& uv1, const Vec4& color);
+
+    QuadMesh CreateQuadMesh(usize capacity);
+    void DestroyQuadMesh(QuadMesh& mesh);
+    void SetQuadMeshData(QuadMesh& mesh, const QuadVertex* vertices, usize count);
+
+    // every vertex of the mesh must use texture slot 0
+    void DrawQuadMesh(const QuadMesh& mesh, const Texture2D& texture);
+
+    // sprite vertices expanded away from the render thread, each worker fills
+    // its own builder. submitted builders are merged in submission order at
+    // End(), or before anything else is drawn so draw order is kept
+    struct BatchBuilder {
+        ArenaList<QuadVertex> vertices;
+        ArenaList<Texture2D> textures; // one per quad
+    };
+
+    // storage comes from the frame arena, so builders are created on the main thread
+    BatchBuilder CreateBatchBuilder(usize quadCapacity);
+
+    // same as DrawTexture, safe to call from any thread on its own builder
+    void BatchTexture(BatchBuilder& builder, const Texture2D& texture, const Mat3x2& matrix, const Vec4& color);
+
+    // the builder must not change until it is merged
+    void SubmitBatch(const BatchBuilder& builder);
+
+    LineMesh CreateLineMesh(usize capacity, BufferUsage usage = BUFFER_STATIC);
+    void DestroyLineMesh(LineMesh& mesh);
+    void SetLineMeshData(LineMesh& mesh, const LineVertex* vertices, usize count);
+
+    // draws count vertices starting at first, both must be even
+    void DrawLineMesh(const LineMesh& mesh, usize first, usize count);
 }
 
 #endif
\ No newline at end of file
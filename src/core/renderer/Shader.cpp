@@ -1,10 +1,195 @@
+#include "GLState.h"
 #include "Shader.h"
 #include "core/Util.h"
 
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <string.h>
 
 #include <glad/glad.h>
 
+using namespace Renderer2D;
+
+/* PROGRAM BINARY CACHE */
+
+// GL_OES_get_program_binary, glad was generated without it
+#define GL_PROGRAM_BINARY_LENGTH_OES 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS_OES 0x87FE
+
+typedef void (APIENTRYP PFNGLGETPROGRAMBINARYOESPROC)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+typedef void (APIENTRYP PFNGLPROGRAMBINARYOESPROC)(GLuint program, GLenum binaryFormat, const void* binary, GLint length);
+
+#define PROGRAM_CACHE_MAGIC 0x50524F47 // "PROG"
+
+struct ProgramCacheHeader {
+    u32 magic;
+    u32 format;
+    u32 length;
+};
+
+static PFNGLGETPROGRAMBINARYOESPROC m_getProgramBinary;
+static PFNGLPROGRAMBINARYOESPROC m_programBinary;
+
+static std::string m_cacheDirectory;
+
+// binaries are only valid for the driver that produced them
+static u64 m_driverHash;
+
+static u64 HashString(u64 hash, const char* string) {
+    // include the terminator so "ab" + "c" and "a" + "bc" differ
+    return Util::HashBytes(hash, string, strlen(string) + 1);
+}
+
+static bool HasExtension(const char* name) {
+    const char* extensions = (const char*)glGetString(GL_EXTENSIONS);
+    usize length = strlen(name);
+
+    for (const char* found = extensions; found && (found = strstr(found, name)); found += length) {
+        bool startsToken = (found == extensions) || (found[-1] == ' ');
+        bool endsToken   = (found[length] == ' ') || (found[length] == '\0');
+
+        if (startsToken && endsToken) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static std::string CachePath(u64 key) {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+
+    return m_cacheDirectory + "/" + name;
+}
+
+static u32 LoadCachedProgram(u64 key) {
+    if (!m_programBinary) {
+        return 0;
+    }
+
+    std::string data = Util::ReadBinaryFile(CachePath(key));
+
+    if (data.size() < sizeof(ProgramCacheHeader)) {
+        return 0;
+    }
+
+    ProgramCacheHeader header;
+    memcpy(&header, data.data(), sizeof(header));
+
+    if (header.magic != PROGRAM_CACHE_MAGIC || header.length != data.size() - sizeof(header)) {
+        return 0;
+    }
+
+    u32 program = glCreateProgram();
+    m_programBinary(program, header.format, data.data() + sizeof(header), header.length);
+
+    // a driver update can reject binaries it wrote itself, the caller compiles from source again
+    int linkStatus = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &linkStatus);
+
+    if (linkStatus == GL_FALSE) {
+        glDeleteProgram(program);
+        return 0;
+    }
+
+    return program;
+}
+
+static void SaveCachedProgram(u64 key, u32 program) {
+    if (!m_getProgramBinary) {
+        return;
+    }
+
+    int length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH_OES, &length);
+
+    if (length <= 0) {
+        return;
+    }
+
+    std::string binary(length, '\0');
+
+    ProgramCacheHeader header = { .magic = PROGRAM_CACHE_MAGIC };
+    m_getProgramBinary(program, length, &length, &header.format, binary.data());
+
+    header.length = length;
+
+    std::ofstream file(CachePath(key), std::ios::out | std::ios::binary | std::ios::trunc);
+
+    if (!file) {
+        std::cout << "ERROR: Failed to write program cache " << CachePath(key) << std::endl;
+        return;
+    }
+
+    file.write((const char*)&header, sizeof(header));
+    file.write(binary.data(), header.length);
+}
+
+void Renderer2D::InitProgramCache(const char* directory, void* (*getProcAddress)(const char* name)) {
+    m_getProgramBinary = NULL;
+    m_programBinary    = NULL;
+
+    int formatCount = 0;
+
+    if (HasExtension("GL_OES_get_program_binary")) {
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS_OES, &formatCount);
+    }
+
+    if (formatCount <= 0) {
+        return;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+
+    if (error) {
+        std::cout << "ERROR: Failed to create program cache directory " << directory << std::endl;
+        return;
+    }
+
+    m_getProgramBinary = (PFNGLGETPROGRAMBINARYOESPROC)getProcAddress("glGetProgramBinaryOES");
+    m_programBinary    = (PFNGLPROGRAMBINARYOESPROC)getProcAddress("glProgramBinaryOES");
+    m_cacheDirectory   = directory;
+
+    m_driverHash = Util::HASH_SEED;
+    m_driverHash = HashString(m_driverHash, (const char*)glGetString(GL_VENDOR));
+    m_driverHash = HashString(m_driverHash, (const char*)glGetString(GL_RENDERER));
+    m_driverHash = HashString(m_driverHash, (const char*)glGetString(GL_VERSION));
+}
+
+/* SHADERS */
+
+// "#define name value" lines go right after #version, which has to stay the first line
+static std::string InjectDefines(const std::string& source, const ShaderDefines& defines) {
+    if (defines.Empty()) {
+        return source;
+    }
+
+    std::string block;
+
+    for (int i = 0; i < defines.Size(); i++) {
+        block += "#define ";
+        block += defines[i].name;
+        block += " ";
+        block += std::to_string(defines[i].value);
+        block += "\n";
+    }
+
+    usize insertAt = 0;
+
+    if (source.compare(0, 8, "#version") == 0) {
+        usize lineEnd = source.find('\n');
+        insertAt = (lineEnd == std::string::npos) ? source.size() : lineEnd + 1;
+    }
+
+    std::string result = source;
+    result.insert(insertAt, block);
+
+    return result;
+}
+
 static const char* GetGLName(u32 value) {
     switch (value) {
         case GL_VERTEX_SHADER: return "VERTEX SHADER";
@@ -38,11 +223,40 @@ static u32 CreateShaderStage(const std::string& source, u32 shaderType) {
     return shader;
 }
 
-u32 Renderer2D::CreateShader(const std::string& vertexSource, const std::string& fragmentSource, const List<Attribute, MAX_ATTRIBUTE_COUNT>& attributes) {
+// array uniforms are reported as "name[0]"
+static void ReadUniforms(Shader& shader) {
+    int count = 0;
+    glGetProgramiv(shader.program, GL_ACTIVE_UNIFORMS, &count);
+
+    for (int i = 0; i < count; i++) {
+        if (shader.uniforms.Full()) {
+            std::cout << "ERROR: Shader has more than " << MAX_SHADER_UNIFORMS << " uniforms" << std::endl;
+            break;
+        }
+
+        ShaderUniform uniform = {};
+
+        int length = 0;
+        u32 type   = 0;
+
+        glGetActiveUniform(shader.program, i, MAX_UNIFORM_NAME, &length, &uniform.size, &type, uniform.name);
+
+        char* bracket = strchr(uniform.name, '[');
+
+        if (bracket) {
+            *bracket = '\0';
+        }
+
+        uniform.location = glGetUniformLocation(shader.program, uniform.name);
+        shader.uniforms.Push(uniform);
+    }
+}
+
+static u32 LinkProgram(const std::string& vertexSource, const std::string& fragmentSource, const List<Attribute, MAX_ATTRIBUTE_COUNT>& attributes) {
     u32 program = glCreateProgram();
 
     for (int i = 0; i < attributes.Size(); i++) {
-        glBindAttribLocation(program, i, attributes[i].name.c_str());
+        glBindAttribLocation(program, i, attributes[i].name);
     }
 
     u32 vertexShader   = CreateShaderStage(vertexSource, GL_VERTEX_SHADER);
@@ -70,31 +284,80 @@ u32 Renderer2D::CreateShader(const std::string& vertexSource, const std::string&
     return program;
 }
 
-void Renderer2D::DestroyShader(u32 shader) {
-    glDeleteProgram(shader);
+Renderer2D::Shader Renderer2D::CreateShader(const std::string& vertexSource, const std::string& fragmentSource, const List<Attribute, MAX_ATTRIBUTE_COUNT>& attributes, const ShaderDefines& defines) {
+    std::string vertex   = InjectDefines(vertexSource, defines);
+    std::string fragment = InjectDefines(fragmentSource, defines);
+
+    // attribute locations are baked into the binary, so the layout is part of the key
+    u64 key = m_driverHash;
+    key = HashString(key, vertex.c_str());
+    key = HashString(key, fragment.c_str());
+
+    for (int i = 0; i < attributes.Size(); i++) {
+        key = HashString(key, attributes[i].name);
+    }
+
+    u32 program = LoadCachedProgram(key);
+
+    if (!program) {
+        program = LinkProgram(vertex, fragment, attributes);
+
+        int linkStatus = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &linkStatus);
+
+        if (linkStatus != GL_FALSE) {
+            SaveCachedProgram(key, program);
+        }
+    }
+
+    Shader shader = {
+        .program       = program,
+        .attributeMask = (1u << attributes.Size()) - 1,
+    };
+
+    ReadUniforms(shader);
+
+    return shader;
 }
 
-void Renderer2D::UseShader(u32 shader) {
-    glUseProgram(shader);
+void Renderer2D::DestroyShader(Shader& shader) {
+    ForgetProgram(shader.program);
+    glDeleteProgram(shader.program);
+
+    shader.program = 0;
+    shader.uniforms.Clear();
 }
 
-void Renderer2D::SetUniform(u32 shader, int value, const char* name) {
-    int loc = glGetUniformLocation(shader, name);
-    
-    glUseProgram(shader);
-    glUniform1i(loc, value);
+void Renderer2D::UseShader(const Shader& shader) {
+    UseProgram(shader.program);
 }
 
-void Renderer2D::SetUniform(u32 shader, const Mat4& mat, const char* name) {
-    int loc = glGetUniformLocation(shader, name);
-    
-    glUseProgram(shader);
-    glUniformMatrix4fv(loc, 1, true, (float*)&mat);
+const ShaderUniform* Renderer2D::FindUniform(const Shader& shader, const char* name) {
+    for (int i = 0; i < shader.uniforms.Size(); i++) {
+        if (strcmp(shader.uniforms[i].name, name) == 0) {
+            return &shader.uniforms[i];
+        }
+    }
+
+    return NULL;
 }
 
-void Renderer2D::SetUniformIndex(u32 shader, int index, int value, const char* name) {
-    int loc = glGetUniformLocation(shader, name);
-    
-    glUseProgram(shader);
-    glUniform1i(loc + index, value);
-}
\ No newline at end of file
+int Renderer2D::UniformLocation(const Shader& shader, const char* name) {
+    const ShaderUniform* uniform = FindUniform(shader, name);
+    return uniform ? uniform->location : -1;
+}
+
+void Renderer2D::SetUniform(const Shader& shader, int location, int value) {
+    UseProgram(shader.program);
+    glUniform1i(location, value);
+}
+
+void Renderer2D::SetUniform(const Shader& shader, int location, const Mat4& mat) {
+    UseProgram(shader.program);
+    glUniformMatrix4fv(location, 1, true, (float*)&mat);
+}
+
+void Renderer2D::SetUniformArray(const Shader& shader, int location, const int* values, int count) {
+    UseProgram(shader.program);
+    glUniform1iv(location, count, values);
+}
@@ -4,18 +4,56 @@
 #include "Buffer.h"
 #include "LinearMath.h"
 
+#include <string>
+
 namespace Renderer2D {
 
-u32 CreateShader(const std::string& vertexSource, const std::string& fragmentSource, const List<Attribute, MAX_ATTRIBUTE_COUNT>& attributes);
-void DestroyShader(u32 shader);
+inline constexpr int MAX_SHADER_UNIFORMS = 16;
+inline constexpr int MAX_UNIFORM_NAME    = 32;
+inline constexpr int MAX_SHADER_DEFINES  = 8;
+
+// injected as "#define name value" right after the #version line of both
+// stages, one source file builds several specialised programs this way
+struct ShaderDefine {
+    const char* name;
+    int value;
+};
+
+typedef List<ShaderDefine, MAX_SHADER_DEFINES> ShaderDefines;
+
+struct ShaderUniform {
+    char name[MAX_UNIFORM_NAME];
+    int location;
+    int size;
+};
+
+// a linked program with every active uniform resolved once at link time.
+// attribute i of the layout it was created with is bound to location i
+struct Shader {
+    u32 program;
+    u32 attributeMask;
+    List<ShaderUniform, MAX_SHADER_UNIFORMS> uniforms;
+};
+
+// linked programs are saved to directory and loaded back instead of being
+// compiled again, if the driver supports GL_OES_get_program_binary. must be
+// called before the first CreateShader, without it every shader is compiled
+void InitProgramCache(const char* directory, void* (*getProcAddress)(const char* name));
+
+Shader CreateShader(const std::string& vertexSource, const std::string& fragmentSource, const List<Attribute, MAX_ATTRIBUTE_COUNT>& attributes, const ShaderDefines& defines = {});
+void DestroyShader(Shader& shader);
 
-void UseShader(u32 shader);
+void UseShader(const Shader& shader);
 
-void SetUniform(u32 shader, int value, const char* name);
-void SetUniform(u32 shader, const Mat4& mat, const char* name);
+// NULL or -1 if the shader has no such uniform (or the compiler removed
+// it). arrays are looked up by their plain name and resolve to element 0
+const ShaderUniform* FindUniform(const Shader& shader, const char* name);
+int UniformLocation(const Shader& shader, const char* name);
 
-void SetUniformIndex(u32 shader, int index, int value, const char* name);
+void SetUniform(const Shader& shader, int location, int value);
+void SetUniform(const Shader& shader, int location, const Mat4& mat);
+void SetUniformArray(const Shader& shader, int location, const int* values, int count);
 
 }
 
-#endif
\ No newline at end of file
+#endif
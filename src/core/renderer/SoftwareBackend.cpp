@@ -0,0 +1,529 @@
+#include "RenderBackend.h"
+#include "SoftwareBackend.h"
+#include "core/Memory.h"
+
+#include <iostream>
+#include <vector>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <stb_image.h>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+using namespace Renderer2D;
+
+#define MAX_SOFTWARE_MESHES 512
+
+struct SoftwareTexture {
+    u32 width;
+    u32 height;
+    std::vector<u32> pixels;
+};
+
+struct SoftwareMesh {
+    MeshType type;
+    std::vector<u8> vertices;
+};
+
+// a triangle edge as a*x + b*y + c, positive on the inside
+struct Edge {
+    f32 a;
+    f32 b;
+    f32 c;
+
+    // pixel centres exactly on a shared edge belong to only one triangle
+    bool topLeft;
+};
+
+static int m_width;
+static int m_height;
+static std::vector<u32> m_framebuffer;
+
+static Mat4 m_projection;
+
+// handles are index + 1, textures live until shutdown
+static std::vector<SoftwareTexture> m_textures;
+static Pool<SoftwareMesh, MAX_SOFTWARE_MESHES> m_meshes;
+
+/* COLOR */
+
+// one RGBA pixel in [0, 1], a whole pixel fits in one sse register
+#ifdef LINEAR_MATH_SSE2
+typedef __m128 Color;
+
+static inline Color Splat(f32 s) {
+    return _mm_set1_ps(s);
+}
+
+static inline Color Add(Color a, Color b) {
+    return _mm_add_ps(a, b);
+}
+
+static inline Color Mul(Color a, Color b) {
+    return _mm_mul_ps(a, b);
+}
+
+static inline f32 Alpha(Color c) {
+    return _mm_cvtss_f32(_mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 3, 3)));
+}
+
+static inline Color UnpackColor(u32 pixel) {
+    __m128i zero = _mm_setzero_si128();
+    __m128i bytes = _mm_cvtsi32_si128((int)pixel);
+
+    bytes = _mm_unpacklo_epi8(bytes, zero);
+    bytes = _mm_unpacklo_epi16(bytes, zero);
+
+    return _mm_mul_ps(_mm_cvtepi32_ps(bytes), _mm_set1_ps(1.0f / 255.0f));
+}
+
+static inline u32 PackColor(Color c) {
+    c = _mm_min_ps(_mm_max_ps(c, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+
+    __m128i ints = _mm_cvtps_epi32(_mm_mul_ps(c, _mm_set1_ps(255.0f)));
+    ints = _mm_packs_epi32(ints, ints);
+    ints = _mm_packus_epi16(ints, ints);
+
+    return (u32)_mm_cvtsi128_si32(ints);
+}
+#else
+typedef Vec4 Color;
+
+static inline Color Splat(f32 s) {
+    return { s, s, s, s };
+}
+
+static inline Color Add(Color a, Color b) {
+    return a + b;
+}
+
+static inline Color Mul(Color a, Color b) {
+    return { a.x * b.x, a.y * b.y, a.z * b.z, a.w * b.w };
+}
+
+static inline f32 Alpha(Color c) {
+    return c.w;
+}
+
+static inline Color UnpackColor(u32 pixel) {
+    const f32 scale = 1.0f / 255.0f;
+
+    return {
+        (f32)((pixel >>  0) & 0xFF) * scale,
+        (f32)((pixel >>  8) & 0xFF) * scale,
+        (f32)((pixel >> 16) & 0xFF) * scale,
+        (f32)((pixel >> 24) & 0xFF) * scale,
+    };
+}
+
+static inline u32 PackChannel(f32 value) {
+    value = (value < 0.0f) ? 0.0f : (value > 1.0f) ? 1.0f : value;
+    return (u32)lrintf(value * 255.0f);
+}
+
+static inline u32 PackColor(Color c) {
+    return PackChannel(c.x) | (PackChannel(c.y) << 8) | (PackChannel(c.z) << 16) | (PackChannel(c.w) << 24);
+}
+#endif
+
+static inline Color LoadColor(const Vec4& v) {
+#ifdef LINEAR_MATH_SSE2
+    return LoadVec4(v);
+#else
+    return v;
+#endif
+}
+
+// GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA on every channel, alpha included
+static inline void BlendPixel(u32* pixel, Color color) {
+    f32 alpha = Alpha(color);
+
+    if (alpha >= 1.0f) {
+        *pixel = PackColor(color);
+        return;
+    }
+
+    if (alpha <= 0.0f) {
+        return;
+    }
+
+    Color dst = UnpackColor(*pixel);
+    *pixel = PackColor(Add(Mul(color, Splat(alpha)), Mul(dst, Splat(1.0f - alpha))));
+}
+
+// nearest filtering with repeat wrapping, same as the gl sampler state
+static inline Color SampleTexture(const SoftwareTexture* texture, f32 u, f32 v) {
+    int x = (int)floorf(u * texture->width) % (int)texture->width;
+    int y = (int)floorf(v * texture->height) % (int)texture->height;
+
+    if (x < 0) x += texture->width;
+    if (y < 0) y += texture->height;
+
+    return UnpackColor(texture->pixels[y * texture->width + x]);
+}
+
+static const SoftwareTexture* GetTexture(u32 texture) {
+    if (texture == 0 || texture > m_textures.size()) {
+        return NULL;
+    }
+
+    return &m_textures[texture - 1];
+}
+
+/* RASTERIZER */
+
+// clip space to pixels, y down
+static inline Vec2 ToPixel(const Vec2& position) {
+    Vec2 clip = m_projection * position;
+
+    return {
+        (clip.x + 1.0f) * 0.5f * m_width,
+        (1.0f - clip.y) * 0.5f * m_height,
+    };
+}
+
+static Edge MakeEdge(const Vec2& p, const Vec2& q) {
+    f32 dx = q.x - p.x;
+    f32 dy = q.y - p.y;
+
+    return {
+        .a       = -dy,
+        .b       = dx,
+        .c       = (dy * p.x) - (dx * p.y),
+        .topLeft = (dy < 0.0f) || (dy == 0.0f && dx > 0.0f),
+    };
+}
+
+static inline bool Inside(const Edge& edge, f32 w) {
+    return edge.topLeft ? (w >= 0.0f) : (w > 0.0f);
+}
+
+static inline void ShadePixel(u32* pixel, const QuadVertex* v[3], const SoftwareTexture* texture, f32 l0, f32 l1, f32 l2) {
+    Color color = Add(Add(Mul(LoadColor(v[0]->color), Splat(l0)), Mul(LoadColor(v[1]->color), Splat(l1))), Mul(LoadColor(v[2]->color), Splat(l2)));
+
+    if (texture) {
+        f32 u  = (v[0]->textureCoord.x * l0) + (v[1]->textureCoord.x * l1) + (v[2]->textureCoord.x * l2);
+        f32 tv = (v[0]->textureCoord.y * l0) + (v[1]->textureCoord.y * l1) + (v[2]->textureCoord.y * l2);
+
+        color = Mul(color, SampleTexture(texture, u, tv));
+    }
+
+    BlendPixel(pixel, color);
+}
+
+// edge function rasterizer, the projection is orthographic so screen space
+// interpolation is perspective correct
+static void DrawTriangle(const QuadVertex& a, const QuadVertex& b, const QuadVertex& c, const SoftwareTexture* texture) {
+    const QuadVertex* v[3] = { &a, &b, &c };
+    Vec2 p[3] = { ToPixel(a.position), ToPixel(b.position), ToPixel(c.position) };
+
+    f32 area = ((p[1].x - p[0].x) * (p[2].y - p[0].y)) - ((p[1].y - p[0].y) * (p[2].x - p[0].x));
+
+    if (fabsf(area) < 1e-6f) {
+        return;
+    }
+
+    // one winding for every triangle, so the inside of every edge is positive
+    if (area < 0.0f) {
+        Vec2 tp = p[1]; p[1] = p[2]; p[2] = tp;
+        const QuadVertex* tv = v[1]; v[1] = v[2]; v[2] = tv;
+        area = -area;
+    }
+
+    // e0 is opposite vertex 0, so e0 / area is the weight of vertex 0
+    Edge e0 = MakeEdge(p[1], p[2]);
+    Edge e1 = MakeEdge(p[2], p[0]);
+    Edge e2 = MakeEdge(p[0], p[1]);
+
+    int minX = (int)floorf(fminf(p[0].x, fminf(p[1].x, p[2].x)));
+    int minY = (int)floorf(fminf(p[0].y, fminf(p[1].y, p[2].y)));
+    int maxX = (int)ceilf(fmaxf(p[0].x, fmaxf(p[1].x, p[2].x)));
+    int maxY = (int)ceilf(fmaxf(p[0].y, fmaxf(p[1].y, p[2].y)));
+
+    minX = (minX < 0) ? 0 : minX;
+    minY = (minY < 0) ? 0 : minY;
+    maxX = (maxX > m_width - 1) ? m_width - 1 : maxX;
+    maxY = (maxY > m_height - 1) ? m_height - 1 : maxY;
+
+    if (minX > maxX || minY > maxY) {
+        return;
+    }
+
+    f32 invArea = 1.0f / area;
+
+    for (int y = minY; y <= maxY; y++) {
+        f32 py = y + 0.5f;
+        f32 px = minX + 0.5f;
+
+        f32 w0 = (e0.a * px) + (e0.b * py) + e0.c;
+        f32 w1 = (e1.a * px) + (e1.b * py) + e1.c;
+        f32 w2 = (e2.a * px) + (e2.b * py) + e2.c;
+
+        u32* row = &m_framebuffer[y * m_width];
+        int x = minX;
+
+#ifdef LINEAR_MATH_SSE2
+        // four pixels per step, most of a sprite's bounding box is either
+        // fully inside or fully outside so whole steps get skipped
+        const __m128 lanes = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+        const __m128 zero  = _mm_setzero_ps();
+
+        __m128 vw0 = _mm_add_ps(_mm_set1_ps(w0), _mm_mul_ps(lanes, _mm_set1_ps(e0.a)));
+        __m128 vw1 = _mm_add_ps(_mm_set1_ps(w1), _mm_mul_ps(lanes, _mm_set1_ps(e1.a)));
+        __m128 vw2 = _mm_add_ps(_mm_set1_ps(w2), _mm_mul_ps(lanes, _mm_set1_ps(e2.a)));
+
+        __m128 step0 = _mm_set1_ps(e0.a * 4.0f);
+        __m128 step1 = _mm_set1_ps(e1.a * 4.0f);
+        __m128 step2 = _mm_set1_ps(e2.a * 4.0f);
+
+        for (; x + 3 <= maxX; x += 4) {
+            __m128 in0 = e0.topLeft ? _mm_cmpge_ps(vw0, zero) : _mm_cmpgt_ps(vw0, zero);
+            __m128 in1 = e1.topLeft ? _mm_cmpge_ps(vw1, zero) : _mm_cmpgt_ps(vw1, zero);
+            __m128 in2 = e2.topLeft ? _mm_cmpge_ps(vw2, zero) : _mm_cmpgt_ps(vw2, zero);
+
+            int mask = _mm_movemask_ps(_mm_and_ps(in0, _mm_and_ps(in1, in2)));
+
+            if (mask) {
+                alignas(16) f32 l0[4];
+                alignas(16) f32 l1[4];
+                alignas(16) f32 l2[4];
+
+                __m128 scale = _mm_set1_ps(invArea);
+                _mm_store_ps(l0, _mm_mul_ps(vw0, scale));
+                _mm_store_ps(l1, _mm_mul_ps(vw1, scale));
+                _mm_store_ps(l2, _mm_mul_ps(vw2, scale));
+
+                for (int i = 0; i < 4; i++) {
+                    if (mask & (1 << i)) {
+                        ShadePixel(&row[x + i], v, texture, l0[i], l1[i], l2[i]);
+                    }
+                }
+            }
+
+            vw0 = _mm_add_ps(vw0, step0);
+            vw1 = _mm_add_ps(vw1, step1);
+            vw2 = _mm_add_ps(vw2, step2);
+        }
+
+        // the tail of the row continues from where the vector loop stopped
+        w0 += e0.a * (x - minX);
+        w1 += e1.a * (x - minX);
+        w2 += e2.a * (x - minX);
+#endif
+
+        for (; x <= maxX; x++) {
+            if (Inside(e0, w0) && Inside(e1, w1) && Inside(e2, w2)) {
+                ShadePixel(&row[x], v, texture, w0 * invArea, w1 * invArea, w2 * invArea);
+            }
+
+            w0 += e0.a;
+            w1 += e1.a;
+            w2 += e2.a;
+        }
+    }
+}
+
+// dda over the longer axis, the last pixel is left out like a gl line
+static void DrawLine(const LineVertex& a, const LineVertex& b) {
+    Vec2 p0 = ToPixel(a.position);
+    Vec2 p1 = ToPixel(b.position);
+
+    f32 dx = p1.x - p0.x;
+    f32 dy = p1.y - p0.y;
+
+    int steps = (int)ceilf(fmaxf(fabsf(dx), fabsf(dy)));
+
+    if (steps == 0) {
+        return;
+    }
+
+    f32 invSteps = 1.0f / steps;
+
+    for (int i = 0; i < steps; i++) {
+        f32 t = (i + 0.5f) * invSteps;
+
+        int x = (int)floorf(p0.x + dx * t);
+        int y = (int)floorf(p0.y + dy * t);
+
+        if (x < 0 || y < 0 || x >= m_width || y >= m_height) {
+            continue;
+        }
+
+        Color color = Add(Mul(LoadColor(a.color), Splat(1.0f - t)), Mul(LoadColor(b.color), Splat(t)));
+        BlendPixel(&m_framebuffer[y * m_width + x], color);
+    }
+}
+
+/* BACKEND */
+
+static void Init(int viewportWidth, int viewportHeight) {
+    std::cout << "Renderer:     software" << std::endl;
+}
+
+static void Shutdown() {
+    m_textures.clear();
+    m_framebuffer.clear();
+}
+
+static void InvalidateState() {
+    // nothing cached, nothing outside the renderer touches the framebuffer
+}
+
+static void SetViewport(int width, int height) {
+    m_width  = width;
+    m_height = height;
+    m_framebuffer.resize((usize)width * height);
+}
+
+static void SetProjection(const Mat4& projection) {
+    m_projection = projection;
+}
+
+static void Clear(const Vec4& color) {
+    u32 pixel = PackColor(LoadColor(color));
+
+    for (usize i = 0; i < m_framebuffer.size(); i++) {
+        m_framebuffer[i] = pixel;
+    }
+}
+
+static u32 CreateTexture(u32 width, u32 height, const void* pixels) {
+    SoftwareTexture texture = {
+        .width  = width,
+        .height = height,
+    };
+
+    texture.pixels.resize((usize)width * height);
+    memcpy(texture.pixels.data(), pixels, sizeof(u32) * width * height);
+
+    m_textures.push_back(std::move(texture));
+    return (u32)m_textures.size();
+}
+
+static void DrawQuads(const QuadVertex* vertices, usize count, const u32* textures, usize textureCount) {
+    for (usize i = 0; i + 2 < count; i += 3) {
+        usize slot = (usize)vertices[i].textureID;
+        const SoftwareTexture* texture = (slot < textureCount) ? GetTexture(textures[slot]) : NULL;
+
+        DrawTriangle(vertices[i], vertices[i + 1], vertices[i + 2], texture);
+    }
+}
+
+static void DrawLines(const LineVertex* vertices, usize count) {
+    for (usize i = 0; i + 1 < count; i += 2) {
+        DrawLine(vertices[i], vertices[i + 1]);
+    }
+}
+
+// handles are pool index + 1, so 0 is never a valid mesh
+static SoftwareMesh* GetMesh(u32 mesh) {
+    ASSERT(mesh != 0);
+    return m_meshes.Get(mesh - 1);
+}
+
+static u32 CreateMesh(MeshType type, usize capacity, BufferUsage usage) {
+    usize vertexSize = (type == MESH_QUADS) ? sizeof(QuadVertex) : sizeof(LineVertex);
+
+    SoftwareMesh* mesh = m_meshes.Create();
+    mesh->type = type;
+    mesh->vertices.reserve(vertexSize * capacity);
+
+    return m_meshes.IndexOf(mesh) + 1;
+}
+
+static void DestroyMesh(u32 handle) {
+    m_meshes.Destroy(GetMesh(handle));
+}
+
+static void SetMeshData(u32 handle, const void* vertices, usize count) {
+    SoftwareMesh* mesh = GetMesh(handle);
+    usize vertexSize = (mesh->type == MESH_QUADS) ? sizeof(QuadVertex) : sizeof(LineVertex);
+
+    const u8* bytes = (const u8*)vertices;
+    mesh->vertices.assign(bytes, bytes + vertexSize * count);
+}
+
+static void DrawMesh(u32 handle, usize first, usize count, u32 texture) {
+    SoftwareMesh* mesh = GetMesh(handle);
+
+    if (mesh->type == MESH_QUADS) {
+        const QuadVertex* vertices = (const QuadVertex*)mesh->vertices.data() + first;
+        const SoftwareTexture* meshTexture = GetTexture(texture);
+
+        for (usize i = 0; i + 2 < count; i += 3) {
+            DrawTriangle(vertices[i], vertices[i + 1], vertices[i + 2], meshTexture);
+        }
+    }
+    else {
+        DrawLines((const LineVertex*)mesh->vertices.data() + first, count);
+    }
+}
+
+const RenderBackend& Renderer2D::SoftwareBackend() {
+    static const RenderBackend backend = {
+        .name            = "Software",
+        .init            = Init,
+        .shutdown        = Shutdown,
+        .invalidateState = InvalidateState,
+        .setViewport     = SetViewport,
+        .setProjection   = SetProjection,
+        .clear           = Clear,
+        .createTexture   = CreateTexture,
+        .drawQuads       = DrawQuads,
+        .drawLines       = DrawLines,
+        .createMesh      = CreateMesh,
+        .destroyMesh     = DestroyMesh,
+        .setMeshData     = SetMeshData,
+        .drawMesh        = DrawMesh,
+    };
+
+    return backend;
+}
+
+/* FRAMEBUFFER */
+
+const u32* Renderer2D::SoftwareFramebuffer(int* width, int* height) {
+    *width  = m_width;
+    *height = m_height;
+
+    return m_framebuffer.data();
+}
+
+bool Renderer2D::WriteFramebuffer(const char* filename) {
+    if (!stbi_write_png(filename, m_width, m_height, 4, m_framebuffer.data(), m_width * sizeof(u32))) {
+        std::cout << "ERROR: Failed to write framebuffer to " << filename << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+int Renderer2D::CompareFramebuffer(const char* filename) {
+    int w, h, comp;
+    u8* golden = stbi_load(filename, &w, &h, &comp, 4);
+
+    if (!golden) {
+        std::cout << "ERROR: Failed to load golden image " << filename << std::endl;
+        return -1;
+    }
+
+    if (w != m_width || h != m_height) {
+        std::cout << "ERROR: Golden image is " << w << "x" << h << ", framebuffer is " << m_width << "x" << m_height << std::endl;
+        stbi_image_free(golden);
+        return -1;
+    }
+
+    const u8* pixels = (const u8*)m_framebuffer.data();
+    int maxDifference = 0;
+
+    for (usize i = 0; i < (usize)w * h * 4; i++) {
+        int difference = abs((int)pixels[i] - (int)golden[i]);
+        maxDifference = (difference > maxDifference) ? difference : maxDifference;
+    }
+
+    stbi_image_free(golden);
+    return maxDifference;
+}
@@ -0,0 +1,19 @@
+#ifndef CORE_RENDERER_SOFTWARE_BACKEND_H
+#define CORE_RENDERER_SOFTWARE_BACKEND_H
+
+#include "Basic.h"
+
+// the software backend draws into an RGBA8 framebuffer in memory, rows top
+// to bottom. it has no window, it is for headless runs, benchmarks and
+// golden image tests
+namespace Renderer2D {
+    const u32* SoftwareFramebuffer(int* width, int* height);
+
+    bool WriteFramebuffer(const char* filename);
+
+    // largest difference of any channel against the png, -1 if it could not be
+    // loaded or the size does not match
+    int CompareFramebuffer(const char* filename);
+}
+
+#endif
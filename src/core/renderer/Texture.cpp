@@ -1,32 +1,42 @@
+#include "Renderer2D.h"
 #include "Texture.h"
-
-#include <glad/glad.h>
+#include "Map.h"
+#include "core/Util.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
-Texture2D Renderer2D::CreateTexture(u32 width, u32 height, void* pixels) {
-    u32 id = 0;
-    
-    glGenTextures(1, &id);
-    glBindTexture(GL_TEXTURE_2D, id);
+#include <string.h>
+
+#define MAX_CACHED_TEXTURES 256
+#define MAX_TEXTURE_FILENAME 256
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+struct CachedTexture {
+    Texture2D texture;
+    char filename[MAX_TEXTURE_FILENAME];
+};
 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
-    glBindTexture(GL_TEXTURE_2D, 0);
+// textures loaded from disk, keyed by a hash of the file name
+static Map<u64, CachedTexture, MAX_CACHED_TEXTURES> m_textureCache;
 
+// render id to cache key, for going back from a texture to its file
+static Map<u32, u64, MAX_CACHED_TEXTURES> m_textureKeys;
+
+Texture2D Renderer2D::CreateTexture(u32 width, u32 height, void* pixels) {
     return {
-        .renderID = id,
+        .renderID = Backend().createTexture(width, height, pixels),
         .width    = width,
         .height   = height,
     };
 }
 
 Texture2D Renderer2D::LoadTexture(const char* filename) {
+    u64 key = Util::HashBytes(Util::HASH_SEED, filename, strlen(filename));
+
+    if (m_textureCache.Contains(key)) {
+        return m_textureCache.Get(key).texture;
+    }
+
     //stbi_set_flip_vertically_on_load(true);
 
     int w, h, comp;
@@ -35,5 +45,21 @@ Texture2D Renderer2D::LoadTexture(const char* filename) {
     Texture2D texture = CreateTexture(w, h, data);
     stbi_image_free(data);
 
+    if (!m_textureCache.Full() && strlen(filename) < MAX_TEXTURE_FILENAME) {
+        CachedTexture cached = { .texture = texture };
+        strcpy(cached.filename, filename);
+
+        m_textureCache.Add(key, cached);
+        m_textureKeys.Add(texture.renderID, key);
+    }
+
     return texture;
+}
+
+const char* Renderer2D::TextureFilename(const Texture2D& texture) {
+    if (!m_textureKeys.Contains(texture.renderID)) {
+        return NULL;
+    }
+
+    return m_textureCache.Get(m_textureKeys.Get(texture.renderID)).filename;
 }
\ No newline at end of file
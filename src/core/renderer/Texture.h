@@ -12,8 +12,12 @@ struct Texture2D {
 namespace Renderer2D {
 
 Texture2D CreateTexture(u32 width, u32 height, void* pixels);
+// loading the same file twice returns the texture created the first time
 Texture2D LoadTexture(const char* filename);
 
+// the file a texture was loaded from, NULL for textures created from memory
+const char* TextureFilename(const Texture2D& texture);
+
 }
 
 #endif
\ No newline at end of file
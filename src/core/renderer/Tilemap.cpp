@@ -0,0 +1,141 @@
+#include "Tilemap.h"
+
+using namespace Renderer2D;
+
+static constexpr usize TILES_PER_CHUNK = TILEMAP_CHUNK_SIZE * TILEMAP_CHUNK_SIZE;
+static constexpr usize MAX_CHUNK_VERTICES = 6 * TILES_PER_CHUNK;
+
+// scratch space for rebuilding a chunk, too big for the stack
+static List<QuadVertex, MAX_CHUNK_VERTICES> m_chunkVertices;
+
+static void BuildChunk(const Tilemap& tilemap, u32 chunkX, u32 chunkY, TilemapChunk& chunk) {
+    m_chunkVertices.Clear();
+
+    u32 tilesetColumns = tilemap.tileset.width / tilemap.tilesetTileSize;
+
+    f32 tileU = (f32)tilemap.tilesetTileSize / tilemap.tileset.width;
+    f32 tileV = (f32)tilemap.tilesetTileSize / tilemap.tileset.height;
+
+    for (u32 y = 0; y < TILEMAP_CHUNK_SIZE; y++) {
+        for (u32 x = 0; x < TILEMAP_CHUNK_SIZE; x++) {
+            u16 tile = chunk.tiles[(y * TILEMAP_CHUNK_SIZE) + x];
+
+            if (tile == EMPTY_TILE) {
+                continue;
+            }
+
+            f32 x0 = ((chunkX * TILEMAP_CHUNK_SIZE) + x) * tilemap.tileSize;
+            f32 y0 = ((chunkY * TILEMAP_CHUNK_SIZE) + y) * tilemap.tileSize;
+            f32 x1 = x0 + tilemap.tileSize;
+            f32 y1 = y0 + tilemap.tileSize;
+
+            f32 u0 = (tile % tilesetColumns) * tileU;
+            f32 v0 = (tile / tilesetColumns) * tileV;
+            f32 u1 = u0 + tileU;
+            f32 v1 = v0 + tileV;
+
+            QuadVertex tl = { { x0, y0 }, { u0, v0 }, WHITE, 0.0f };
+            QuadVertex tr = { { x1, y0 }, { u1, v0 }, WHITE, 0.0f };
+            QuadVertex br = { { x1, y1 }, { u1, v1 }, WHITE, 0.0f };
+            QuadVertex bl = { { x0, y1 }, { u0, v1 }, WHITE, 0.0f };
+
+            m_chunkVertices.Push(tl);
+            m_chunkVertices.Push(tr);
+            m_chunkVertices.Push(br);
+
+            m_chunkVertices.Push(br);
+            m_chunkVertices.Push(bl);
+            m_chunkVertices.Push(tl);
+        }
+    }
+
+    SetQuadMeshData(chunk.mesh, m_chunkVertices.Data(), m_chunkVertices.Size());
+    chunk.dirty = false;
+}
+
+void Renderer2D::InitTilemap(Tilemap& tilemap, const Texture2D& tileset, u32 tilesetTileSize, f32 tileSize, u32 width, u32 height) {
+    tilemap.tileset         = tileset;
+    tilemap.tilesetTileSize = tilesetTileSize;
+    tilemap.tileSize        = tileSize;
+
+    tilemap.width  = width;
+    tilemap.height = height;
+
+    tilemap.chunksX = (width  + TILEMAP_CHUNK_SIZE - 1) / TILEMAP_CHUNK_SIZE;
+    tilemap.chunksY = (height + TILEMAP_CHUNK_SIZE - 1) / TILEMAP_CHUNK_SIZE;
+
+    ASSERT(tilemap.chunksX * tilemap.chunksY <= MAX_TILEMAP_CHUNKS);
+
+    tilemap.chunks.Clear();
+
+    for (u32 i = 0; i < tilemap.chunksX * tilemap.chunksY; i++) {
+        tilemap.chunks.Push({});
+
+        TilemapChunk& chunk = tilemap.chunks[i];
+
+        for (usize t = 0; t < TILES_PER_CHUNK; t++) {
+            chunk.tiles[t] = EMPTY_TILE;
+        }
+
+        chunk.mesh  = CreateQuadMesh(MAX_CHUNK_VERTICES);
+        chunk.dirty = true;
+    }
+}
+
+void Renderer2D::DestroyTilemap(Tilemap& tilemap) {
+    for (int i = 0; i < tilemap.chunks.Size(); i++) {
+        DestroyQuadMesh(tilemap.chunks[i].mesh);
+    }
+
+    tilemap.chunks.Clear();
+}
+
+u16 Renderer2D::GetTile(const Tilemap& tilemap, u32 x, u32 y) {
+    if (x >= tilemap.width || y >= tilemap.height) {
+        return EMPTY_TILE;
+    }
+
+    const TilemapChunk& chunk = tilemap.chunks[((y / TILEMAP_CHUNK_SIZE) * tilemap.chunksX) + (x / TILEMAP_CHUNK_SIZE)];
+    return chunk.tiles[((y % TILEMAP_CHUNK_SIZE) * TILEMAP_CHUNK_SIZE) + (x % TILEMAP_CHUNK_SIZE)];
+}
+
+void Renderer2D::SetTile(Tilemap& tilemap, u32 x, u32 y, u16 tile) {
+    if (x >= tilemap.width || y >= tilemap.height) {
+        return;
+    }
+
+    TilemapChunk& chunk = tilemap.chunks[((y / TILEMAP_CHUNK_SIZE) * tilemap.chunksX) + (x / TILEMAP_CHUNK_SIZE)];
+    u16& current = chunk.tiles[((y % TILEMAP_CHUNK_SIZE) * TILEMAP_CHUNK_SIZE) + (x % TILEMAP_CHUNK_SIZE)];
+
+    if (current != tile) {
+        current = tile;
+        chunk.dirty = true;
+    }
+}
+
+void Renderer2D::DrawTilemap(Tilemap& tilemap, const Camera2D& camera) {
+    Rect view = camera.VisibleRect();
+    f32 chunkWorldSize = TILEMAP_CHUNK_SIZE * tilemap.tileSize;
+
+    i32 minX = (i32)floorf(view.position.x / chunkWorldSize);
+    i32 minY = (i32)floorf(view.position.y / chunkWorldSize);
+    i32 maxX = (i32)floorf((view.position.x + view.size.x) / chunkWorldSize);
+    i32 maxY = (i32)floorf((view.position.y + view.size.y) / chunkWorldSize);
+
+    if (minX < 0) minX = 0;
+    if (minY < 0) minY = 0;
+    if (maxX >= (i32)tilemap.chunksX) maxX = tilemap.chunksX - 1;
+    if (maxY >= (i32)tilemap.chunksY) maxY = tilemap.chunksY - 1;
+
+    for (i32 y = minY; y <= maxY; y++) {
+        for (i32 x = minX; x <= maxX; x++) {
+            TilemapChunk& chunk = tilemap.chunks[(y * tilemap.chunksX) + x];
+
+            if (chunk.dirty) {
+                BuildChunk(tilemap, x, y, chunk);
+            }
+
+            DrawQuadMesh(chunk.mesh, tilemap.tileset);
+        }
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef CORE_RENDERER_TILEMAP_H
+#define CORE_RENDERER_TILEMAP_H
+
+#include "Camera.h"
+#include "Renderer2D.h"
+#include "Texture.h"
+
+#define TILEMAP_CHUNK_SIZE 32
+#define MAX_TILEMAP_CHUNKS 256
+
+inline constexpr u16 EMPTY_TILE = 0xFFFF;
+
+// TILEMAP_CHUNK_SIZE x TILEMAP_CHUNK_SIZE tiles with a prebuilt mesh,
+// the mesh is only rebuilt when a tile inside the chunk changes
+struct TilemapChunk {
+    u16 tiles[TILEMAP_CHUNK_SIZE * TILEMAP_CHUNK_SIZE];
+    Renderer2D::QuadMesh mesh;
+    bool dirty;
+};
+
+struct Tilemap {
+    Texture2D tileset;
+    u32 tilesetTileSize;    // size of a tile in the tileset, in pixels
+    f32 tileSize;           // size of a tile in world units
+
+    u32 width;              // in tiles
+    u32 height;             // in tiles
+
+    u32 chunksX;
+    u32 chunksY;
+    List<TilemapChunk, MAX_TILEMAP_CHUNKS> chunks;
+};
+
+namespace Renderer2D {
+
+void InitTilemap(Tilemap& tilemap, const Texture2D& tileset, u32 tilesetTileSize, f32 tileSize, u32 width, u32 height);
+void DestroyTilemap(Tilemap& tilemap);
+
+u16 GetTile(const Tilemap& tilemap, u32 x, u32 y);
+void SetTile(Tilemap& tilemap, u32 x, u32 y, u16 tile);
+
+// rebuilds dirty chunks and draws every chunk the camera can see, one draw call per chunk
+void DrawTilemap(Tilemap& tilemap, const Camera2D& camera);
+
+}
+
+#endif
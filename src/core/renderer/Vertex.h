@@ -0,0 +1,22 @@
+#ifndef CORE_RENDERER_VERTEX_H
+#define CORE_RENDERER_VERTEX_H
+
+#include "LinearMath.h"
+
+namespace Renderer2D {
+
+struct QuadVertex {
+    Vec2 position;
+    Vec2 textureCoord;
+    Vec4 color;
+    f32 textureID;
+};
+
+struct LineVertex {
+    Vec2 position;
+    Vec4 color;
+};
+
+}
+
+#endif
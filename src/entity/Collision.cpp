@@ -0,0 +1,193 @@
+#include "core/Jobs.h"
+#include "Collision.h"
+
+#include <algorithm>
+#include <string.h>
+
+bool BoxesOverlap(const OrientedBox& a, const OrientedBox& b, Vec2& normal, f32& depth) {
+    Vec2 d = b.center - a.center;
+
+    const Vec2 axes[4] = { a.axisX, a.axisY, b.axisX, b.axisY };
+    depth = INFINITY;
+
+    for (int i = 0; i < 4; i++) {
+        const Vec2& axis = axes[i];
+
+        f32 radiusA = (a.halfSize.x * fabsf(a.axisX.Dot(axis))) + (a.halfSize.y * fabsf(a.axisY.Dot(axis)));
+        f32 radiusB = (b.halfSize.x * fabsf(b.axisX.Dot(axis))) + (b.halfSize.y * fabsf(b.axisY.Dot(axis)));
+
+        f32 distance = d.Dot(axis);
+        f32 overlap  = radiusA + radiusB - fabsf(distance);
+
+        if (overlap < 0.0f) {
+            return false;
+        }
+
+        if (overlap < depth) {
+            depth  = overlap;
+            normal = (distance < 0.0f) ? Vec2 { -axis.x, -axis.y } : axis;
+        }
+    }
+
+    return true;
+}
+
+void CollisionDetector::Sort(const EntityData* entities, usize count) {
+    usize colliderCount = 0;
+
+    for (usize i = 0; i < count; i++) {
+        m_isCollider[i] = (entities[i].flags & (COLLIDER | TRANSFORM)) == (COLLIDER | TRANSFORM);
+        colliderCount += m_isCollider[i];
+    }
+
+    // any permutation of the current colliders is a fine start for the sort,
+    // the previous order still is one unless colliders came or went
+    bool reuse = (colliderCount == m_colliderCount);
+
+    for (usize i = 0; reuse && i < m_colliderCount; i++) {
+        reuse = (m_order[i] < count) && m_isCollider[m_order[i]];
+    }
+
+    if (!reuse) {
+        colliderCount = 0;
+
+        for (usize i = 0; i < count; i++) {
+            if (m_isCollider[i]) {
+                m_order[colliderCount] = (u32)i;
+                colliderCount += 1;
+            }
+        }
+    }
+
+    m_colliderCount = colliderCount;
+
+    for (usize i = 0; i < count; i++) {
+        m_sortKeys[i] = m_isCollider[i] ? BoundingRect(entities[i].worldMatrix.matrix).position.x : 0.0f;
+    }
+
+    // ties go by index, so the order only depends on the bounds and not on
+    // the order the sort started from
+    auto less = [&](u32 a, u32 b) {
+        return (m_sortKeys[a] < m_sortKeys[b]) || (m_sortKeys[a] == m_sortKeys[b] && a < b);
+    };
+
+    if (!reuse) {
+        std::sort(m_order, m_order + colliderCount, less);
+        return;
+    }
+
+    // insertion sort, close to linear when little moved since the last tick
+    for (usize i = 1; i < colliderCount; i++) {
+        u32 item = m_order[i];
+        usize j = i;
+
+        while (j > 0 && less(item, m_order[j - 1])) {
+            m_order[j] = m_order[j - 1];
+            j -= 1;
+        }
+
+        m_order[j] = item;
+    }
+}
+
+usize CollisionDetector::Sweep(usize first, usize last, Contact* contacts, usize capacity, bool& overflowed) {
+    usize contactCount = 0;
+    overflowed = false;
+
+    for (usize i = first; i < last; i++) {
+        f32 maxX = m_maxX[i];
+        f32 minY = m_minY[i];
+        f32 maxY = m_maxY[i];
+
+        for (usize j = i + 1; j < m_colliderCount && m_minX[j] <= maxX; j++) {
+            if (m_minY[j] > maxY || m_maxY[j] < minY) {
+                continue;
+            }
+
+            Vec2 normal;
+            f32 depth;
+
+            if (!BoxesOverlap(m_boxes[i], m_boxes[j], normal, depth)) {
+                continue;
+            }
+
+            // everything after this in sweep order is dropped
+            if (contactCount == capacity) {
+                overflowed = true;
+                return contactCount;
+            }
+
+            u32 a = m_order[i];
+            u32 b = m_order[j];
+
+            if (a > b) {
+                contacts[contactCount] = { b, a, { -normal.x, -normal.y }, depth };
+            }
+            else {
+                contacts[contactCount] = { a, b, normal, depth };
+            }
+
+            contactCount += 1;
+        }
+    }
+
+    return contactCount;
+}
+
+void CollisionDetector::Detect(const EntityData* entities, usize count, bool parallel) {
+    Sort(entities, count);
+
+    for (usize i = 0; i < m_colliderCount; i++) {
+        const EntityData& entity = entities[m_order[i]];
+        Rect bounds = BoundingRect(entity.worldMatrix.matrix);
+
+        m_minX[i] = bounds.position.x;
+        m_maxX[i] = bounds.position.x + bounds.size.x;
+        m_minY[i] = bounds.position.y;
+        m_maxY[i] = bounds.position.y + bounds.size.y;
+
+        m_boxes[i] = OrientedBox::FromEntity(entity);
+    }
+
+    m_contactCount = 0;
+    m_overflowed   = false;
+
+    if (m_colliderCount == 0) {
+        return;
+    }
+
+    u32 chunkCount = parallel ? Jobs::ChunkCount(m_colliderCount, COLLISION_CHUNK_SIZE) : 1;
+    chunkCount = (chunkCount < MAX_COLLISION_CHUNKS) ? chunkCount : MAX_COLLISION_CHUNKS;
+
+    if (chunkCount <= 1) {
+        m_contactCount = Sweep(0, m_colliderCount, m_contacts, MAX_CONTACTS, m_overflowed);
+        return;
+    }
+
+    Jobs::ParallelFor(m_colliderCount, chunkCount, [&](usize first, usize last, u32 chunk) {
+        usize offset = MAX_CONTACTS * chunk / chunkCount;
+        usize capacity = (MAX_CONTACTS * (chunk + 1) / chunkCount) - offset;
+
+        m_chunkFirst[chunk]  = first;
+        m_chunkCounts[chunk] = Sweep(first, last, m_contacts + offset, capacity, m_chunkOverflowed[chunk]);
+    });
+
+    // pack the slices in chunk order, the first one is already in place
+    for (u32 chunk = 0; chunk < chunkCount; chunk++) {
+        // a full slice depends on how many chunks there were, the rest of the
+        // sweep is redone in order into what is left of the buffer, so the
+        // dropped contacts are the same as for a single chunk
+        if (m_chunkOverflowed[chunk]) {
+            m_contactCount += Sweep(m_chunkFirst[chunk], m_colliderCount, m_contacts + m_contactCount, MAX_CONTACTS - m_contactCount, m_overflowed);
+            return;
+        }
+
+        const Contact* slice = m_contacts + (MAX_CONTACTS * chunk / chunkCount);
+
+        if (slice != m_contacts + m_contactCount) {
+            memmove(m_contacts + m_contactCount, slice, m_chunkCounts[chunk] * sizeof(Contact));
+        }
+
+        m_contactCount += m_chunkCounts[chunk];
+    }
+}
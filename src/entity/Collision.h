@@ -0,0 +1,110 @@
+#ifndef ENTITY_COLLISION_H
+#define ENTITY_COLLISION_H
+
+#include "Entity.h"
+
+#define MAX_CONTACTS 32768
+
+// the sweep is split into at most this many chunks, one per job thread
+#define MAX_COLLISION_CHUNKS 64
+
+// fewer colliders than this per thread are not worth handing out
+#define COLLISION_CHUNK_SIZE 256
+
+// a sprite's box, centred on the transform and turned with it
+struct OrientedBox {
+    Vec2 center;
+    Vec2 axisX;
+    Vec2 axisY;
+    Vec2 halfSize;
+
+    // from the cached sin/cos, so this is no trig
+    static OrientedBox FromEntity(const EntityData& entity) {
+        const WorldMatrix& worldMatrix = entity.worldMatrix;
+
+        return {
+            .center   = entity.transform.position,
+            .axisX    = { worldMatrix.cosRotation, worldMatrix.sinRotation },
+            .axisY    = { -worldMatrix.sinRotation, worldMatrix.cosRotation },
+            .halfSize = { fabsf(entity.transform.size.x) * 0.5f, fabsf(entity.transform.size.y) * 0.5f },
+        };
+    }
+
+    bool Contains(const Vec2& point) const {
+        Vec2 d = point - center;
+        return (fabsf(d.Dot(axisX)) <= halfSize.x) && (fabsf(d.Dot(axisY)) <= halfSize.y);
+    }
+};
+
+// separating axis test over the four box axes. on overlap normal is the axis
+// of least penetration pointing from a to b and depth how far they overlap along it
+bool BoxesOverlap(const OrientedBox& a, const OrientedBox& b, Vec2& normal, f32& depth);
+
+// a and b are dense entity indices, a < b
+struct Contact {
+    u32 a;
+    u32 b;
+    Vec2 normal;
+    f32 depth;
+};
+
+// sweep and prune over the COLLIDER entities: their bounds are sorted by
+// min x into structure of arrays, each one is only tested against the ones
+// that start before it ends, and pairs whose bounds overlap get the SAT test.
+// the sort starts from the previous order, which is nearly sorted already
+class CollisionDetector {
+public:
+    // parallel splits the sweep over the job threads, only ever from the
+    // main thread (a world stepped on a job thread must pass false).
+    // contacts come out in the same order either way
+    void Detect(const EntityData* entities, usize count, bool parallel);
+
+    // the contacts index entities by where they were, the world drops them
+    // as soon as entities move in storage
+    void ClearContacts() {
+        m_contactCount = 0;
+        m_overflowed   = false;
+    }
+
+    const Contact* Contacts() const {
+        return m_contacts;
+    }
+
+    usize ContactCount() const {
+        return m_contactCount;
+    }
+
+    // there were more than MAX_CONTACTS pairs, the ones past it in sweep
+    // order were dropped (the same ones whatever the thread count)
+    bool Overflowed() const {
+        return m_overflowed;
+    }
+
+private:
+    void Sort(const EntityData* entities, usize count);
+    usize Sweep(usize first, usize last, Contact* contacts, usize capacity, bool& overflowed);
+
+    usize m_colliderCount = 0;
+
+    // dense entity index of every collider, sorted by min x
+    u32 m_order[MAX_ENTITY_COUNT];
+    f32 m_sortKeys[MAX_ENTITY_COUNT];
+    bool m_isCollider[MAX_ENTITY_COUNT];
+
+    // bounds and boxes in sorted order
+    f32 m_minX[MAX_ENTITY_COUNT];
+    f32 m_maxX[MAX_ENTITY_COUNT];
+    f32 m_minY[MAX_ENTITY_COUNT];
+    f32 m_maxY[MAX_ENTITY_COUNT];
+    OrientedBox m_boxes[MAX_ENTITY_COUNT];
+
+    // every chunk writes into its own slice, the slices are packed afterwards
+    Contact m_contacts[MAX_CONTACTS];
+    usize m_chunkFirst[MAX_COLLISION_CHUNKS];
+    usize m_chunkCounts[MAX_COLLISION_CHUNKS];
+    bool m_chunkOverflowed[MAX_COLLISION_CHUNKS];
+    usize m_contactCount = 0;
+    bool m_overflowed = false;
+};
+
+#endif
@@ -0,0 +1,30 @@
+#include "CommandBuffer.h"
+
+void CommandBuffer::Push(const EntityCommand& command) {
+    u32 index = m_count.fetch_add(1, std::memory_order_relaxed);
+
+    // running out of commands is a sizing bug, the command is dropped
+    ASSERT(index < MAX_ENTITY_COMMANDS);
+
+    if (index < MAX_ENTITY_COMMANDS) {
+        m_commands[index] = command;
+    }
+}
+
+EntityID CommandBuffer::Create(u64 flags, const EntityInit& init) {
+    EntityID id = m_ids.Next();
+    Push({ .type = COMMAND_CREATE, .id = id, .flags = flags, .init = init });
+    return id;
+}
+
+void CommandBuffer::Destroy(EntityID id) {
+    Push({ .type = COMMAND_DESTROY, .id = id });
+}
+
+void CommandBuffer::AddFlags(EntityID id, u64 flags) {
+    Push({ .type = COMMAND_ADD_FLAGS, .id = id, .flags = flags });
+}
+
+void CommandBuffer::RemoveFlags(EntityID id, u64 flags) {
+    Push({ .type = COMMAND_REMOVE_FLAGS, .id = id, .flags = flags });
+}
@@ -0,0 +1,65 @@
+#ifndef ENTITY_COMMAND_BUFFER_H
+#define ENTITY_COMMAND_BUFFER_H
+
+#include "Entity.h"
+
+#include <atomic>
+
+#define MAX_ENTITY_COMMANDS 4096
+
+enum EntityCommandType {
+    COMMAND_CREATE,
+    COMMAND_DESTROY,
+    COMMAND_ADD_FLAGS,
+    COMMAND_REMOVE_FLAGS,
+};
+
+struct EntityCommand {
+    EntityCommandType type;
+    EntityID id;
+    u64 flags;
+    EntityInit init;    // only used by COMMAND_CREATE
+};
+
+// structural changes recorded while systems run and applied later by
+// World::Playback, so nothing moves under a system that is iterating.
+// recording is lock free: a slot is claimed with a single atomic add, so
+// any number of threads can record into the same buffer at once
+class CommandBuffer {
+public:
+    // ids of created entities come from the owning world
+    explicit CommandBuffer(EntityIDGenerator& ids)
+        : m_ids(ids) {}
+
+    // the id is reserved now, the entity only exists after playback
+    EntityID Create(u64 flags, const EntityInit& init = {});
+    void Destroy(EntityID id);
+
+    void AddFlags(EntityID id, u64 flags);
+    void RemoveFlags(EntityID id, u64 flags);
+
+    // not thread safe, only call once every recording thread is done
+    usize Size() const {
+        u32 count = m_count.load(std::memory_order_acquire);
+        return (count < MAX_ENTITY_COMMANDS) ? count : MAX_ENTITY_COMMANDS;
+    }
+
+    const EntityCommand& operator[](usize index) const {
+        ASSERT(index < Size());
+        return m_commands[index];
+    }
+
+    void Clear() {
+        m_count.store(0, std::memory_order_release);
+    }
+
+private:
+    void Push(const EntityCommand& command);
+
+    EntityIDGenerator& m_ids;
+
+    std::atomic<u32> m_count = 0;
+    EntityCommand m_commands[MAX_ENTITY_COMMANDS];
+};
+
+#endif
@@ -1,20 +1,100 @@
 #ifndef ENTITY_H
 #define ENTITY_H
 
+#include "core/Random.h"
 #include "core/renderer/Texture.h"
 #include "LinearMath.h"
 #include "List.h"
 
-#define MAX_ENTITY_COUNT 256
+#include <atomic>
+
+#define MAX_ENTITY_COUNT 4096
 #define MAX_PATH_SIZE 512
 
+// systems with an UpdateRate each keep a last update tick in every entity
+#define MAX_SCHEDULED_SYSTEMS 8
+
 using EntityID = u64;
 
+// ids are splitmix64 of a per world seed plus a counter. that is unique
+// (a bijection of the counter), well spread for the Map, the same for the
+// same seed and order of creation, and lock free to hand out
+class EntityIDGenerator {
+public:
+    void Seed(u64 seed) {
+        m_seed = seed;
+        m_counter.store(0, std::memory_order_relaxed);
+    }
+
+    EntityID Next() {
+        EntityID id;
+
+        do {
+            u64 x = m_seed + (m_counter.fetch_add(1, std::memory_order_relaxed) * 0x9E3779B97F4A7C15ull);
+            id = Random::SplitMix64(x);
+        } while (id == 0);
+
+        return id;
+    }
+
+    // for snapshots, restoring both continues the exact id sequence
+    u64 SeedValue() const {
+        return m_seed;
+    }
+
+    u64 Counter() const {
+        return m_counter.load(std::memory_order_relaxed);
+    }
+
+    void Restore(u64 seed, u64 counter) {
+        m_seed = seed;
+        m_counter.store(counter, std::memory_order_relaxed);
+    }
+
+private:
+    u64 m_seed = 0;
+    std::atomic<u64> m_counter = 0;
+};
+
 enum EntityFlags {
     TRANSFORM  = 1 << 0,
     SPRITE     = 1 << 1,
     MOTION     = 1 << 2,
     PATH       = 1 << 3,
+    COLLIDER   = 1 << 4,
+};
+
+// how relevant an entity is right now, decides how often scheduled systems update it
+enum LODTier {
+    LOD_NEAR,
+    LOD_MID,
+    LOD_FAR,
+    LOD_TIER_COUNT,
+};
+
+enum DirtyFlags {
+    DIRTY_TRANSFORM = 1 << 0,
+
+    // new or teleported, the previous tick state is reset so nothing is interpolated
+    DIRTY_SNAP      = 1 << 1,
+};
+
+// cached result of Transform::Matrix2D(), only recomputed by
+// World::UpdateTransforms() when the entity is marked DIRTY_TRANSFORM
+struct WorldMatrix {
+    Mat3x2 matrix;
+
+    // rotation the cached sin/cos belong to, so a pure translation skips the trig
+    f32 rotation    = 0.0f;
+    f32 sinRotation = 0.0f;
+    f32 cosRotation = 1.0f;
+
+    // state at the start of the current simulation tick, rendering blends
+    // from here to the current transform
+    Vec2 previousPosition;
+    Vec2 previousSize;
+    f32 previousSin = 0.0f;
+    f32 previousCos = 1.0f;
 };
 
 struct Motion {
@@ -22,18 +102,125 @@ struct Motion {
     Vec2 acceleration;
 };
 
+// points before next have been reached already. they stay in the list so
+// following a path never shifts it, and so anything built from the points
+// only has to be rebuilt when version changes
 struct Path {
     List<Vec2, MAX_PATH_SIZE> points;
+    u32 next;
+    u32 version;
+
+    usize Remaining() const {
+        return points.Size() - next;
+    }
+
+    const Vec2& Target() const {
+        return points[next];
+    }
+
+    void Advance() {
+        ASSERT(next < points.Size());
+        next += 1;
+    }
+
+    void Push(const Vec2& point) {
+        points.Push(point);
+        version += 1;
+    }
+
+    void Clear() {
+        points.Clear();
+        next = 0;
+        version += 1;
+    }
+};
+
+// initial component values for entities that are created later or in bulk
+struct EntityInit {
+    Transform transform;
+    Motion motion;
+    Texture2D texture;
+};
+
+// template for spawning many entities with the same flags and components
+struct Prefab {
+    u64 flags;
+    EntityInit init;
 };
 
 struct EntityData {
     EntityID id;
     u64 flags;
+    u32 dirty;
+
+    u32 lodTier;
+    u32 lastUpdate[MAX_SCHEDULED_SYSTEMS];
 
     Transform transform;
+    WorldMatrix worldMatrix;
     Motion motion;
     Texture2D texture;
-    List<Vec2, MAX_PATH_SIZE> path;
+    Path path;
+};
+
+// world matrix blended between the last two ticks by alpha. the rotation is
+// an nlerp of the cached sin/cos, so there is no trig per sprite, and a half
+// turn within one tick (the pair passes through zero) snaps to the current one
+inline Mat3x2 InterpolatedMatrix(const EntityData& entity, f32 alpha) {
+    const WorldMatrix& worldMatrix = entity.worldMatrix;
+
+    Vec2 position = worldMatrix.previousPosition + (entity.transform.position - worldMatrix.previousPosition) * alpha;
+    Vec2 size     = worldMatrix.previousSize + (entity.transform.size - worldMatrix.previousSize) * alpha;
+
+    f32 s = worldMatrix.previousSin + (worldMatrix.sinRotation - worldMatrix.previousSin) * alpha;
+    f32 c = worldMatrix.previousCos + (worldMatrix.cosRotation - worldMatrix.previousCos) * alpha;
+    f32 length = sqrtf((s * s) + (c * c));
+
+    if (length < 0.001f) {
+        s = worldMatrix.sinRotation;
+        c = worldMatrix.cosRotation;
+    }
+    else {
+        s /= length;
+        c /= length;
+    }
+
+    return AffineMatrix(position, size, s, c);
+}
+
+// maps a component type to its flag and its storage in EntityData,
+// this is what lets World::Each resolve component access at compile time
+template<typename T>
+struct Component;
+
+template<>
+struct Component<Transform> {
+    static constexpr u64 flag = TRANSFORM;
+    static Transform& Get(EntityData& entity) { return entity.transform; }
+};
+
+template<>
+struct Component<WorldMatrix> {
+    static constexpr u64 flag = TRANSFORM;
+    static WorldMatrix& Get(EntityData& entity) { return entity.worldMatrix; }
+};
+
+template<>
+struct Component<Motion> {
+    static constexpr u64 flag = MOTION;
+    static Motion& Get(EntityData& entity) { return entity.motion; }
+};
+
+template<>
+struct Component<Texture2D> {
+    static constexpr u64 flag = SPRITE;
+    static Texture2D& Get(EntityData& entity) { return entity.texture; }
+};
+
+template<>
+struct Component<Path> {
+    static constexpr u64 flag = PATH;
+    static Path& Get(EntityData& entity) { return entity.path; }
 };
 
 #endif
\ No newline at end of file
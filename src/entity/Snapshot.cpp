@@ -0,0 +1,287 @@
+#include "core/renderer/Texture.h"
+#include "core/Util.h"
+#include "Snapshot.h"
+
+#include <iostream>
+#include <string.h>
+
+static usize AlignUp(usize value, usize alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static_assert(SNAPSHOT_ENTITY_SIZE % alignof(EntityData) == 0, "saved entities must stay aligned");
+
+SnapshotWriter::~SnapshotWriter() {
+    Finish();
+    m_image.Release();
+}
+
+bool SnapshotWriter::Begin(const World& world, const std::string& filename) {
+    Finish();
+
+    m_file.open(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+
+    if (!m_file) {
+        std::cout << "ERROR: Failed to open snapshot file for writing: " << filename << std::endl;
+        return false;
+    }
+
+    usize entityCount = world.EntityCount();
+    const EntityData* worldEntities = world.Entities();
+
+    // first pass finds the textures and the path points, so the size of the
+    // file is known up front
+    Map<u32, u32, MAX_SNAPSHOT_TEXTURES> textureIndices;
+    const char* textureFiles[MAX_SNAPSHOT_TEXTURES];
+    u32 textureCount = 0;
+    usize pointCount = 0;
+
+    for (usize i = 0; i < entityCount; i++) {
+        const Texture2D& texture = worldEntities[i].texture;
+        pointCount += worldEntities[i].path.points.Size();
+
+        if (textureIndices.Contains(texture.renderID) || textureCount == MAX_SNAPSHOT_TEXTURES) {
+            continue;
+        }
+
+        const char* textureFile = Renderer2D::TextureFilename(texture);
+
+        if (textureFile) {
+            textureIndices.Add(texture.renderID, textureCount);
+            textureFiles[textureCount] = textureFile;
+            textureCount += 1;
+        }
+    }
+
+    usize textureOffset = sizeof(SnapshotHeader);
+    usize entityOffset  = AlignUp(textureOffset + (textureCount * sizeof(SnapshotTexture)), SNAPSHOT_ALIGNMENT);
+    usize pathOffset    = AlignUp(entityOffset + (entityCount * SNAPSHOT_ENTITY_SIZE), SNAPSHOT_ALIGNMENT);
+    usize pointOffset   = AlignUp(pathOffset + (entityCount * sizeof(SnapshotPath)), SNAPSHOT_ALIGNMENT);
+    usize size          = pointOffset + (pointCount * sizeof(Vec2));
+
+    // the image of the last save is big enough unless the world grew
+    if (m_image.Capacity() < size) {
+        m_image.Release();
+        m_image.Init(size);
+    }
+
+    m_image.Reset();
+    u8* image = (u8*)m_image.Alloc(size);
+
+    // everything below is written over, only the header, the names and the
+    // padding need to start out zeroed
+    memset(image, 0, entityOffset);
+    memset(image + entityOffset + (entityCount * SNAPSHOT_ENTITY_SIZE), 0, pathOffset - entityOffset - (entityCount * SNAPSHOT_ENTITY_SIZE));
+    memset(image + pathOffset + (entityCount * sizeof(SnapshotPath)), 0, pointOffset - pathOffset - (entityCount * sizeof(SnapshotPath)));
+
+    SnapshotTexture* textures = (SnapshotTexture*)(image + textureOffset);
+    SnapshotPath* paths       = (SnapshotPath*)(image + pathOffset);
+    Vec2* points              = (Vec2*)(image + pointOffset);
+
+    for (u32 i = 0; i < textureCount; i++) {
+        strncpy(textures[i].filename, textureFiles[i], SNAPSHOT_TEXTURE_NAME - 1);
+    }
+
+    u32 firstPoint = 0;
+
+    for (usize i = 0; i < entityCount; i++) {
+        const EntityData& worldEntity = worldEntities[i];
+        const Path& path = worldEntity.path;
+
+        // everything up to the path in one copy, the unused end of the path is never touched
+        EntityData* entity = (EntityData*)(image + entityOffset + (i * SNAPSHOT_ENTITY_SIZE));
+        memcpy((void*)entity, &worldEntity, SNAPSHOT_ENTITY_SIZE);
+
+        Texture2D& texture = entity->texture;
+        texture.renderID = textureIndices.Contains(texture.renderID) ? textureIndices.Get(texture.renderID) + 1 : 0;
+
+        u32 count = (u32)path.points.Size();
+
+        paths[i] = {
+            .firstPoint = firstPoint,
+            .pointCount = count,
+            .next       = path.next,
+            .version    = path.version,
+        };
+
+        memcpy(points + firstPoint, path.points.Data(), count * sizeof(Vec2));
+        firstPoint += count;
+    }
+
+    WorldState state = world.State();
+
+    SnapshotHeader header = {
+        .magic         = SNAPSHOT_MAGIC,
+        .version       = SNAPSHOT_VERSION,
+        .entitySize    = SNAPSHOT_ENTITY_SIZE,
+        .entityCount   = (u32)entityCount,
+        .textureCount  = textureCount,
+        .pointCount    = (u32)pointCount,
+        .tick          = state.tick,
+        .tickDeltaTime = state.tickDeltaTime,
+        .idSeed        = state.idSeed,
+        .idCounter     = state.idCounter,
+        .stateHash     = world.Hash(),
+        .textureOffset = textureOffset,
+        .entityOffset  = entityOffset,
+        .pathOffset    = pathOffset,
+        .pointOffset   = pointOffset,
+    };
+
+    memcpy(image, &header, sizeof(header));
+
+    m_data    = image;
+    m_size    = size;
+    m_written = 0;
+
+    return true;
+}
+
+bool SnapshotWriter::Step(usize budget) {
+    if (!Active()) {
+        return true;
+    }
+
+    usize count = m_size - m_written;
+    count = (count < budget) ? count : budget;
+
+    m_file.write((const char*)m_data + m_written, count);
+    m_written += count;
+
+    if (!m_file) {
+        std::cout << "ERROR: Failed to write snapshot" << std::endl;
+        Finish();
+        return true;
+    }
+
+    if (m_written < m_size) {
+        return false;
+    }
+
+    Finish();
+    return true;
+}
+
+void SnapshotWriter::Finish() {
+    if (m_file.is_open()) {
+        m_file.close();
+    }
+
+    m_data    = NULL;
+    m_size    = 0;
+    m_written = 0;
+}
+
+bool Snapshot::Save(const World& world, const std::string& filename) {
+    SnapshotWriter writer;
+
+    if (!writer.Begin(world, filename)) {
+        return false;
+    }
+
+    writer.Step(SIZE_MAX);
+    return true;
+}
+
+// the saved entity at index, put back together from the mapped file
+static void ReadEntity(const MappedFile& file, const SnapshotHeader& header, usize index, EntityData& entity) {
+    memcpy((void*)&entity, file.data + header.entityOffset + (index * SNAPSHOT_ENTITY_SIZE), SNAPSHOT_ENTITY_SIZE);
+
+    SnapshotPath path;
+    memcpy(&path, file.data + header.pathOffset + (index * sizeof(SnapshotPath)), sizeof(path));
+
+    entity.path.points.Clear();
+    entity.path.points.Grow(path.pointCount);
+    memcpy(entity.path.points.Data(), file.data + header.pointOffset + ((u64)path.firstPoint * sizeof(Vec2)), path.pointCount * sizeof(Vec2));
+
+    entity.path.next    = path.next;
+    entity.path.version = path.version;
+}
+
+// every path a range of the point table that fits in a Path
+static bool ValidPaths(const MappedFile& file, const SnapshotHeader& header) {
+    for (u32 i = 0; i < header.entityCount; i++) {
+        SnapshotPath path;
+        memcpy(&path, file.data + header.pathOffset + (i * sizeof(SnapshotPath)), sizeof(path));
+
+        if (path.pointCount > MAX_PATH_SIZE || path.next > path.pointCount || (u64)path.firstPoint + path.pointCount > header.pointCount) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Snapshot::Load(World& world, const std::string& filename) {
+    MappedFile file;
+
+    if (!Util::MapFile(filename, file)) {
+        std::cout << "ERROR: Failed to open snapshot file: " << filename << std::endl;
+        return false;
+    }
+
+    const SnapshotHeader* header = (const SnapshotHeader*)file.data;
+
+    bool valid = (file.size >= sizeof(SnapshotHeader)) &&
+                 (header->magic == SNAPSHOT_MAGIC) &&
+                 (header->version == SNAPSHOT_VERSION) &&
+                 (header->entitySize == SNAPSHOT_ENTITY_SIZE) &&
+                 (header->entityCount <= MAX_ENTITY_COUNT) &&
+                 (header->textureCount <= MAX_SNAPSHOT_TEXTURES) &&
+                 (header->entityOffset % SNAPSHOT_ALIGNMENT == 0) &&
+                 (header->textureOffset + (u64)header->textureCount * sizeof(SnapshotTexture) <= file.size) &&
+                 (header->entityOffset + (u64)header->entityCount * SNAPSHOT_ENTITY_SIZE <= file.size) &&
+                 (header->pathOffset + (u64)header->entityCount * sizeof(SnapshotPath) <= file.size) &&
+                 (header->pointOffset + (u64)header->pointCount * sizeof(Vec2) <= file.size) &&
+                 ValidPaths(file, *header);
+
+    if (!valid) {
+        std::cout << "ERROR: Not a snapshot file or unsupported version: " << filename << std::endl;
+        Util::UnmapFile(file);
+        return false;
+    }
+
+    // checked before anything is replaced, a broken file leaves the world as it was
+    u64 stateHash = Util::HASH_SEED;
+    EntityData saved;
+
+    for (u32 i = 0; i < header->entityCount; i++) {
+        ReadEntity(file, *header, i, saved);
+        stateHash = HashEntity(stateHash, saved);
+    }
+
+    if (stateHash != header->stateHash) {
+        std::cout << "ERROR: Snapshot state does not match its hash: " << filename << std::endl;
+        Util::UnmapFile(file);
+        return false;
+    }
+
+    const SnapshotTexture* savedTextures = (const SnapshotTexture*)(file.data + header->textureOffset);
+    Texture2D textures[MAX_SNAPSHOT_TEXTURES];
+
+    for (u32 i = 0; i < header->textureCount; i++) {
+        char textureFile[SNAPSHOT_TEXTURE_NAME];
+        memcpy(textureFile, savedTextures[i].filename, SNAPSHOT_TEXTURE_NAME);
+        textureFile[SNAPSHOT_TEXTURE_NAME - 1] = '\0';
+
+        textures[i] = Renderer2D::LoadTexture(textureFile);
+    }
+
+    WorldState state = {
+        .tick          = header->tick,
+        .tickDeltaTime = header->tickDeltaTime,
+        .idSeed        = header->idSeed,
+        .idCounter     = header->idCounter,
+    };
+
+    world.Restore(state, header->entityCount, [&](usize i, EntityData& entity) {
+        ReadEntity(file, *header, i, entity);
+
+        u32 index = entity.texture.renderID;
+        entity.texture.renderID = (index > 0 && index <= header->textureCount) ? textures[index - 1].renderID : 0;
+    });
+
+    Util::UnmapFile(file);
+
+    return true;
+}
@@ -0,0 +1,104 @@
+#ifndef ENTITY_SNAPSHOT_H
+#define ENTITY_SNAPSHOT_H
+
+#include "World.h"
+
+#include <fstream>
+#include <stddef.h>
+#include <string>
+
+#define SNAPSHOT_MAGIC 0x4E534C50 // "PLSN"
+#define SNAPSHOT_VERSION 2
+
+// the entity blob starts on a cache line, so it is aligned in the mapping too
+#define SNAPSHOT_ALIGNMENT 64
+
+#define MAX_SNAPSHOT_TEXTURES 256
+#define SNAPSHOT_TEXTURE_NAME 256
+
+// an entity is saved as everything before its path, exactly as it is in
+// memory, and its path as a range of one shared point table. a path has room
+// for MAX_PATH_SIZE points but most of it is unused, this leaves that out
+#define SNAPSHOT_ENTITY_SIZE offsetof(EntityData, path)
+
+// file layout: SnapshotHeader, SnapshotTexture[textureCount], then each of
+// these on SNAPSHOT_ALIGNMENT: entityCount entities of SNAPSHOT_ENTITY_SIZE
+// bytes, SnapshotPath[entityCount] and Vec2[pointCount]. a snapshot only
+// loads into a build with the same EntityData layout, which entitySize and
+// the version stand in for
+struct SnapshotHeader {
+    u32 magic;
+    u32 version;
+    u32 entitySize;
+    u32 entityCount;
+    u32 textureCount;
+    u32 pointCount;
+
+    u32 tick;
+    f32 tickDeltaTime;
+    u64 idSeed;
+    u64 idCounter;
+
+    // World::Hash when saved, checked before the loaded entities replace anything
+    u64 stateHash;
+
+    u64 textureOffset;
+    u64 entityOffset;
+    u64 pathOffset;
+    u64 pointOffset;
+};
+
+// render ids mean nothing in another run, saved entities hold an index + 1
+// into the texture table instead (0 for textures that were not loaded from a file)
+struct SnapshotTexture {
+    char filename[SNAPSHOT_TEXTURE_NAME];
+};
+
+struct SnapshotPath {
+    u32 firstPoint;
+    u32 pointCount;
+    u32 next;
+    u32 version;
+};
+
+// saves a snapshot a slice at a time so saving never stalls a frame. Begin
+// copies the world into an image of the whole file, Step writes it out.
+// the image is kept for the next save
+class SnapshotWriter {
+public:
+    ~SnapshotWriter();
+
+    bool Begin(const World& world, const std::string& filename);
+
+    // writes up to budget bytes, true once the whole file is written
+    bool Step(usize budget);
+
+    bool Active() const {
+        return m_file.is_open();
+    }
+
+    f32 Progress() const {
+        return (m_size > 0) ? (f32)m_written / (f32)m_size : 0.0f;
+    }
+
+private:
+    void Finish();
+
+    std::ofstream m_file;
+
+    Arena m_image;
+    const u8* m_data = NULL;
+    usize m_size     = 0;
+    usize m_written  = 0;
+};
+
+namespace Snapshot {
+    // Begin and Step until done
+    bool Save(const World& world, const std::string& filename);
+
+    // maps the file and copies the entities straight out of the mapping,
+    // the only fix ups are the paths, the texture ids and the lookup structures
+    bool Load(World& world, const std::string& filename);
+}
+
+#endif
@@ -0,0 +1,106 @@
+#include "SpatialGrid.h"
+
+SpatialGrid::SpatialGrid() {
+    for (int i = 0; i < SPATIAL_GRID_BUCKET_COUNT; i++) {
+        m_buckets[i] = -1;
+    }
+
+    for (int i = 0; i < MAX_ENTITY_COUNT; i++) {
+        m_nodes[i] = { .next = -1, .prev = -1, .inserted = false };
+    }
+}
+
+void SpatialGrid::Update(u32 index, const Rect& bounds) {
+    ASSERT(index < MAX_ENTITY_COUNT);
+
+    Node& node = m_nodes[index];
+
+    i32 cellX = CellCoord(bounds.position.x + (bounds.size.x / 2.0f));
+    i32 cellY = CellCoord(bounds.position.y + (bounds.size.y / 2.0f));
+
+    f32 halfExtent = fmaxf(bounds.size.x, bounds.size.y) / 2.0f;
+
+    if (halfExtent > m_maxHalfExtent) {
+        m_maxHalfExtent = halfExtent;
+    }
+
+    node.bounds = bounds;
+
+    if (node.inserted && node.cellX == cellX && node.cellY == cellY) {
+        return;
+    }
+
+    if (node.inserted) {
+        Unlink(index);
+    }
+
+    node.cellX = cellX;
+    node.cellY = cellY;
+
+    Link(index);
+}
+
+void SpatialGrid::Remove(u32 index) {
+    ASSERT(index < MAX_ENTITY_COUNT);
+
+    if (m_nodes[index].inserted) {
+        Unlink(index);
+    }
+}
+
+void SpatialGrid::Move(u32 from, u32 to) {
+    ASSERT(from < MAX_ENTITY_COUNT && to < MAX_ENTITY_COUNT);
+
+    if (from == to) {
+        return;
+    }
+
+    Remove(to);
+
+    if (!m_nodes[from].inserted) {
+        return;
+    }
+
+    Node node = m_nodes[from];
+    Unlink(from);
+
+    m_nodes[to].bounds = node.bounds;
+    m_nodes[to].cellX  = node.cellX;
+    m_nodes[to].cellY  = node.cellY;
+
+    Link(to);
+}
+
+void SpatialGrid::Link(u32 index) {
+    Node& node = m_nodes[index];
+    u32 bucket = Bucket(node.cellX, node.cellY);
+
+    node.prev = -1;
+    node.next = m_buckets[bucket];
+
+    if (node.next != -1) {
+        m_nodes[node.next].prev = index;
+    }
+
+    m_buckets[bucket] = index;
+    node.inserted = true;
+}
+
+void SpatialGrid::Unlink(u32 index) {
+    Node& node = m_nodes[index];
+
+    if (node.prev != -1) {
+        m_nodes[node.prev].next = node.next;
+    }
+    else {
+        m_buckets[Bucket(node.cellX, node.cellY)] = node.next;
+    }
+
+    if (node.next != -1) {
+        m_nodes[node.next].prev = node.prev;
+    }
+
+    node.next = -1;
+    node.prev = -1;
+    node.inserted = false;
+}
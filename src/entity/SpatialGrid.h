@@ -0,0 +1,94 @@
+#ifndef ENTITY_SPATIAL_GRID_H
+#define ENTITY_SPATIAL_GRID_H
+
+#include "Entity.h"
+
+#define SPATIAL_GRID_CELL_SIZE 128.0f
+#define SPATIAL_GRID_BUCKET_COUNT 1024
+
+// hashed uniform grid over dense entity indices. every entity lives in the
+// cell that contains the center of its bounds, queries are grown by the
+// largest half extent seen so far so big entities are never missed
+class SpatialGrid {
+public:
+    SpatialGrid();
+
+    void Update(u32 index, const Rect& bounds);
+    void Remove(u32 index);
+
+    // an entity moved from one dense index to another (swap remove)
+    void Move(u32 from, u32 to);
+
+    bool Contains(u32 index) const {
+        return m_nodes[index].inserted;
+    }
+
+    // calls fn(index) for every entity whose bounds overlap rect
+    template<typename F>
+    void Query(const Rect& rect, F&& fn) const {
+        Rect area = rect.Expanded(m_maxHalfExtent);
+
+        i32 minX = CellCoord(area.position.x);
+        i32 minY = CellCoord(area.position.y);
+        i32 maxX = CellCoord(area.position.x + area.size.x);
+        i32 maxY = CellCoord(area.position.y + area.size.y);
+
+        i64 cellCount = (i64)(maxX - minX + 1) * (i64)(maxY - minY + 1);
+
+        // visiting more cells than buckets would walk the same chains twice
+        if (cellCount >= SPATIAL_GRID_BUCKET_COUNT) {
+            for (u32 i = 0; i < MAX_ENTITY_COUNT; i++) {
+                if (m_nodes[i].inserted && m_nodes[i].bounds.Overlaps(rect)) {
+                    fn(i);
+                }
+            }
+
+            return;
+        }
+
+        for (i32 y = minY; y <= maxY; y++) {
+            for (i32 x = minX; x <= maxX; x++) {
+                i32 index = m_buckets[Bucket(x, y)];
+
+                while (index != -1) {
+                    const Node& node = m_nodes[index];
+
+                    if (node.cellX == x && node.cellY == y && node.bounds.Overlaps(rect)) {
+                        fn((u32)index);
+                    }
+
+                    index = node.next;
+                }
+            }
+        }
+    }
+
+private:
+    struct Node {
+        Rect bounds;
+        i32 cellX;
+        i32 cellY;
+        i32 next;
+        i32 prev;
+        bool inserted;
+    };
+
+    static i32 CellCoord(f32 value) {
+        return (i32)floorf(value / SPATIAL_GRID_CELL_SIZE);
+    }
+
+    static u32 Bucket(i32 x, i32 y) {
+        u32 hash = ((u32)x * 73856093u) ^ ((u32)y * 19349663u);
+        return hash % SPATIAL_GRID_BUCKET_COUNT;
+    }
+
+    void Link(u32 index);
+    void Unlink(u32 index);
+
+    i32 m_buckets[SPATIAL_GRID_BUCKET_COUNT];
+    Node m_nodes[MAX_ENTITY_COUNT];
+
+    f32 m_maxHalfExtent = 0.0f;
+};
+
+#endif
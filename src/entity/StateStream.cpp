@@ -0,0 +1,721 @@
+#include "StateStream.h"
+
+#include <iostream>
+#include <math.h>
+#include <string.h>
+
+#ifndef WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#ifdef MSG_NOSIGNAL
+#define STREAM_SEND_FLAGS MSG_NOSIGNAL
+#else
+#define STREAM_SEND_FLAGS 0
+#endif
+
+struct ByteWriter {
+    u8* data;
+    usize size;
+    usize capacity;
+};
+
+struct ByteReader {
+    const u8* data;
+    u64 size;
+    u64 offset;
+    bool failed;
+};
+
+static void PutByte(ByteWriter& writer, u8 value) {
+    ASSERT(writer.size < writer.capacity);
+    writer.data[writer.size] = value;
+    writer.size += 1;
+}
+
+static void PutVarint(ByteWriter& writer, u64 value) {
+    while (value >= 0x80) {
+        PutByte(writer, (u8)(value | 0x80));
+        value >>= 7;
+    }
+
+    PutByte(writer, (u8)value);
+}
+
+// small magnitudes of either sign become small varints
+static void PutDelta(ByteWriter& writer, i64 delta) {
+    PutVarint(writer, ((u64)delta << 1) ^ (u64)(delta >> 63));
+}
+
+static u8 GetByte(ByteReader& reader) {
+    if (reader.offset >= reader.size) {
+        reader.failed = true;
+        return 0;
+    }
+
+    u8 value = reader.data[reader.offset];
+    reader.offset += 1;
+
+    return value;
+}
+
+static u64 GetVarint(ByteReader& reader) {
+    u64 value = 0;
+
+    for (int shift = 0; shift < 64; shift += 7) {
+        u8 byte = GetByte(reader);
+        value |= (u64)(byte & 0x7F) << shift;
+
+        if (!(byte & 0x80)) {
+            return value;
+        }
+    }
+
+    reader.failed = true;
+    return 0;
+}
+
+static i64 GetDelta(ByteReader& reader) {
+    u64 value = GetVarint(reader);
+    return (i64)(value >> 1) ^ -(i64)(value & 1);
+}
+
+static void Quantize(const EntityData& entity, QuantizedEntity& quantized) {
+    const Transform& transform = entity.transform;
+    const Motion& motion       = entity.motion;
+
+    quantized = {
+        .id       = entity.id,
+        .flags    = entity.flags,
+        .position = { (i32)lroundf(transform.position.x * STREAM_POSITION_SCALE), (i32)lroundf(transform.position.y * STREAM_POSITION_SCALE) },
+        .size     = { (i32)lroundf(transform.size.x * STREAM_POSITION_SCALE), (i32)lroundf(transform.size.y * STREAM_POSITION_SCALE) },
+        .velocity = { (i32)lroundf(motion.velocity.x * STREAM_VELOCITY_SCALE), (i32)lroundf(motion.velocity.y * STREAM_VELOCITY_SCALE) },
+        .rotation = (u32)lroundf(transform.rotation * (STREAM_ROTATION_STEPS / (2.0f * PI))) & 0xFFFF,
+        .pathNext = entity.path.next,
+        .pathSize = (u32)entity.path.points.Size(),
+    };
+}
+
+static u8 ChangedFields(const QuantizedEntity& a, const QuantizedEntity& b) {
+    u8 fields = 0;
+
+    if (a.flags != b.flags)                                                 fields |= STREAM_FLAGS;
+    if (a.position[0] != b.position[0] || a.position[1] != b.position[1])   fields |= STREAM_POSITION;
+    if (a.rotation != b.rotation)                                           fields |= STREAM_ROTATION;
+    if (a.size[0] != b.size[0] || a.size[1] != b.size[1])                   fields |= STREAM_SIZE;
+    if (a.velocity[0] != b.velocity[0] || a.velocity[1] != b.velocity[1])   fields |= STREAM_VELOCITY;
+    if (a.pathNext != b.pathNext || a.pathSize != b.pathSize)               fields |= STREAM_PATH;
+
+    return fields;
+}
+
+static void PutFields(ByteWriter& writer, u8 fields, const QuantizedEntity& current, const QuantizedEntity& previous) {
+    if (fields & STREAM_FLAGS) {
+        PutVarint(writer, current.flags);
+    }
+
+    if (fields & STREAM_POSITION) {
+        PutDelta(writer, (i64)current.position[0] - previous.position[0]);
+        PutDelta(writer, (i64)current.position[1] - previous.position[1]);
+    }
+
+    // the shorter way round the circle
+    if (fields & STREAM_ROTATION) {
+        PutDelta(writer, (i16)(u16)(current.rotation - previous.rotation));
+    }
+
+    if (fields & STREAM_SIZE) {
+        PutDelta(writer, (i64)current.size[0] - previous.size[0]);
+        PutDelta(writer, (i64)current.size[1] - previous.size[1]);
+    }
+
+    if (fields & STREAM_VELOCITY) {
+        PutDelta(writer, (i64)current.velocity[0] - previous.velocity[0]);
+        PutDelta(writer, (i64)current.velocity[1] - previous.velocity[1]);
+    }
+
+    if (fields & STREAM_PATH) {
+        PutVarint(writer, current.pathNext);
+        PutVarint(writer, current.pathSize);
+    }
+}
+
+static void GetFields(ByteReader& reader, u8 fields, QuantizedEntity& entity) {
+    if (fields & STREAM_FLAGS) {
+        entity.flags = GetVarint(reader);
+    }
+
+    if (fields & STREAM_POSITION) {
+        entity.position[0] += (i32)GetDelta(reader);
+        entity.position[1] += (i32)GetDelta(reader);
+    }
+
+    if (fields & STREAM_ROTATION) {
+        entity.rotation = (entity.rotation + (u32)GetDelta(reader)) & 0xFFFF;
+    }
+
+    if (fields & STREAM_SIZE) {
+        entity.size[0] += (i32)GetDelta(reader);
+        entity.size[1] += (i32)GetDelta(reader);
+    }
+
+    if (fields & STREAM_VELOCITY) {
+        entity.velocity[0] += (i32)GetDelta(reader);
+        entity.velocity[1] += (i32)GetDelta(reader);
+    }
+
+    if (fields & STREAM_PATH) {
+        entity.pathNext = (u32)GetVarint(reader);
+        entity.pathSize = (u32)GetVarint(reader);
+    }
+}
+
+StateStreamWriter::~StateStreamWriter() {
+    Close();
+}
+
+bool StateStreamWriter::Open(const std::string& target, u32 keyframeInterval) {
+    Close();
+
+    if (target.rfind("unix:", 0) == 0) {
+#ifdef WIN32
+        std::cout << "ERROR: Socket streams are not supported on this platform" << std::endl;
+        return false;
+#else
+        std::string path = target.substr(5);
+
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+
+        if (path.size() >= sizeof(address.sun_path)) {
+            std::cout << "ERROR: Socket path too long: " << path << std::endl;
+            return false;
+        }
+
+        strcpy(address.sun_path, path.c_str());
+
+        m_socket = socket(AF_UNIX, SOCK_STREAM, 0);
+
+        if (m_socket == -1 || connect(m_socket, (const sockaddr*)&address, sizeof(address)) != 0) {
+            std::cout << "ERROR: Failed to connect to stream socket: " << path << std::endl;
+            Close();
+            return false;
+        }
+#endif
+    }
+    else {
+        m_file.open(target, std::ios::out | std::ios::binary | std::ios::trunc);
+
+        if (!m_file) {
+            std::cout << "ERROR: Failed to open stream file for writing: " << target << std::endl;
+            return false;
+        }
+    }
+
+    m_keyframeInterval = (keyframeInterval > 0) ? keyframeInterval : 1;
+
+    StreamHeader header = {
+        .magic            = STREAM_MAGIC,
+        .version          = STREAM_VERSION,
+        .keyframeInterval = m_keyframeInterval,
+    };
+
+    Write(&header, sizeof(header));
+
+    return Active();
+}
+
+void StateStreamWriter::Close() {
+    if (m_file.is_open()) {
+        u64 indexOffset = m_bytesWritten;
+
+        u8 index[32];
+        ByteWriter writer = { index, 0, sizeof(index) };
+
+        PutVarint(writer, m_lastTick);
+        PutVarint(writer, m_keyframes.size());
+        Write(index, writer.size);
+
+        StreamKeyframe previous = {};
+
+        for (const StreamKeyframe& keyframe : m_keyframes) {
+            writer.size = 0;
+            PutVarint(writer, keyframe.tick - previous.tick);
+            PutVarint(writer, keyframe.offset - previous.offset);
+            Write(index, writer.size);
+
+            previous = keyframe;
+        }
+
+        if (m_file.is_open()) {
+            m_file.seekp(offsetof(StreamHeader, indexOffset));
+            m_file.write((const char*)&indexOffset, sizeof(indexOffset));
+            m_file.close();
+        }
+    }
+
+#ifndef WIN32
+    if (m_socket != -1) {
+        close(m_socket);
+    }
+#endif
+
+    m_socket = -1;
+
+    m_bytesWritten = 0;
+    m_lastTick     = 0;
+    m_tickBase     = 0;
+    m_keyframes.clear();
+
+    for (u32 slot = 0; slot < m_slotCount; slot++) {
+        if (m_alive[slot]) {
+            m_slots.Remove(m_current[slot].id);
+        }
+    }
+
+    m_freeSlots.Clear();
+    m_slotCount = 0;
+}
+
+void StateStreamWriter::Write(const void* data, usize size) {
+    if (m_file.is_open()) {
+        m_file.write((const char*)data, size);
+
+        if (!m_file) {
+            std::cout << "ERROR: Failed to write stream file" << std::endl;
+            m_file.close();
+            return;
+        }
+    }
+#ifndef WIN32
+    else if (m_socket != -1) {
+        const u8* bytes = (const u8*)data;
+        usize sent = 0;
+
+        while (sent < size) {
+            ssize_t result = send(m_socket, bytes + sent, size - sent, STREAM_SEND_FLAGS);
+
+            if (result <= 0) {
+                std::cout << "ERROR: Stream socket closed" << std::endl;
+                close(m_socket);
+                m_socket = -1;
+                return;
+            }
+
+            sent += (usize)result;
+        }
+    }
+#endif
+
+    m_bytesWritten += size;
+}
+
+void StateStreamWriter::WriteTick(const World& world) {
+    if (!Active()) {
+        return;
+    }
+
+    u32 tick = world.Tick() + m_tickBase;
+    bool keyframe = m_keyframes.empty() || (tick - m_keyframes.back().tick >= m_keyframeInterval);
+
+    // a loaded snapshot rewinds the world tick, the recording carries on from
+    // its last tick with a keyframe so the index stays in order
+    if (!m_keyframes.empty() && tick <= m_lastTick) {
+        m_tickBase = m_lastTick + 1 - world.Tick();
+        tick = m_lastTick + 1;
+        keyframe = true;
+    }
+
+    for (u32 slot = 0; slot < m_slotCount; slot++) {
+        m_seen[slot] = false;
+    }
+
+    const EntityData* entities = world.Entities();
+    usize entityCount = world.EntityCount();
+
+    for (usize i = 0; i < entityCount; i++) {
+        const EntityData& entity = entities[i];
+
+        if (!m_slots.Contains(entity.id)) {
+            continue;
+        }
+
+        u32 slot = m_slots.Get(entity.id);
+        Quantize(entity, m_current[slot]);
+
+        m_fields[slot] = ChangedFields(m_current[slot], m_previous[slot]);
+        m_seen[slot] = true;
+    }
+
+    u32 removedCount = 0;
+
+    for (u32 slot = 0; slot < m_slotCount; slot++) {
+        if (m_alive[slot] && !m_seen[slot]) {
+            removedCount += 1;
+        }
+    }
+
+    ByteWriter writer = { m_record, 0, sizeof(m_record) };
+
+    PutByte(writer, keyframe ? STREAM_KEYFRAME : STREAM_DELTA);
+    PutVarint(writer, tick);
+
+    // a keyframe starts from nothing, the removes are implied
+    PutVarint(writer, keyframe ? 0 : removedCount);
+
+    // removed slots are freed before new entities take theirs, the same order
+    // the reader applies them in
+    for (u32 slot = 0; slot < m_slotCount; slot++) {
+        if (!m_alive[slot] || m_seen[slot]) {
+            continue;
+        }
+
+        if (!keyframe) {
+            PutVarint(writer, slot);
+        }
+
+        m_alive[slot] = false;
+        m_slots.Remove(m_current[slot].id);
+        m_freeSlots.Push(slot);
+    }
+
+    for (usize i = 0; i < entityCount; i++) {
+        const EntityData& entity = entities[i];
+
+        if (m_slots.Contains(entity.id)) {
+            continue;
+        }
+
+        u32 slot;
+
+        if (!m_freeSlots.Empty()) {
+            slot = m_freeSlots[m_freeSlots.Size() - 1];
+            m_freeSlots.Truncate(m_freeSlots.Size() - 1);
+        }
+        else {
+            slot = m_slotCount;
+            m_slotCount += 1;
+        }
+
+        ASSERT(m_slotCount <= MAX_ENTITY_COUNT);
+
+        m_slots.Add(entity.id, slot);
+        m_alive[slot] = true;
+        m_seen[slot]  = true;
+
+        Quantize(entity, m_current[slot]);
+        m_fields[slot] = STREAM_SPAWN | STREAM_ALL_FIELDS;
+    }
+
+    u32 entryCount = 0;
+
+    for (u32 slot = 0; slot < m_slotCount; slot++) {
+        if (!m_alive[slot]) {
+            continue;
+        }
+
+        if (keyframe) {
+            m_fields[slot] = STREAM_SPAWN | STREAM_ALL_FIELDS;
+        }
+
+        if (m_fields[slot] != 0) {
+            entryCount += 1;
+        }
+    }
+
+    PutVarint(writer, entryCount);
+
+    static const QuantizedEntity NOTHING = {};
+    u32 nextSlot = 0;
+
+    for (u32 slot = 0; slot < m_slotCount; slot++) {
+        if (!m_alive[slot] || m_fields[slot] == 0) {
+            continue;
+        }
+
+        u8 fields = m_fields[slot];
+
+        PutVarint(writer, slot - nextSlot);
+        PutByte(writer, fields);
+
+        if (fields & STREAM_SPAWN) {
+            u64 id = m_current[slot].id;
+
+            for (int i = 0; i < 8; i++) {
+                PutByte(writer, (u8)(id >> (i * 8)));
+            }
+        }
+
+        PutFields(writer, fields, m_current[slot], (fields & STREAM_SPAWN) ? NOTHING : m_previous[slot]);
+
+        m_previous[slot] = m_current[slot];
+        nextSlot = slot + 1;
+    }
+
+    if (keyframe) {
+        m_keyframes.push_back({ tick, m_bytesWritten });
+    }
+
+    u8 size[10];
+    ByteWriter sizeWriter = { size, 0, sizeof(size) };
+    PutVarint(sizeWriter, writer.size);
+
+    Write(size, sizeWriter.size);
+    Write(m_record, writer.size);
+
+    m_lastTick = tick;
+}
+
+StateStreamReader::~StateStreamReader() {
+    Close();
+}
+
+bool StateStreamReader::Open(const std::string& filename) {
+    Close();
+
+    if (!Util::MapFile(filename, m_file)) {
+        std::cout << "ERROR: Failed to open stream file: " << filename << std::endl;
+        return false;
+    }
+
+    StreamHeader header = {};
+
+    if (m_file.size >= sizeof(header)) {
+        memcpy(&header, m_file.data, sizeof(header));
+    }
+
+    if (header.magic != STREAM_MAGIC || header.version != STREAM_VERSION) {
+        std::cout << "ERROR: Not a stream file or unsupported version: " << filename << std::endl;
+        Close();
+        return false;
+    }
+
+    // a recording that never closed has no index, its records are still fine
+    if (header.indexOffset == 0 || !ReadIndex(header.indexOffset)) {
+        m_end = m_file.size;
+        ScanRecords();
+    }
+
+    if (m_keyframes.empty()) {
+        std::cout << "ERROR: Stream has no keyframes: " << filename << std::endl;
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void StateStreamReader::Close() {
+    Util::UnmapFile(m_file);
+
+    m_end      = 0;
+    m_lastTick = 0;
+    m_offset   = 0;
+    m_tick     = 0;
+    m_decoded  = false;
+
+    m_keyframes.clear();
+    m_entities.Clear();
+}
+
+bool StateStreamReader::ReadIndex(u64 indexOffset) {
+    if (indexOffset < sizeof(StreamHeader) || indexOffset > m_file.size) {
+        return false;
+    }
+
+    ByteReader reader = { m_file.data, m_file.size, indexOffset, false };
+
+    u32 lastTick = (u32)GetVarint(reader);
+    u64 count    = GetVarint(reader);
+
+    StreamKeyframe keyframe = {};
+
+    for (u64 i = 0; i < count && !reader.failed; i++) {
+        keyframe.tick   += (u32)GetVarint(reader);
+        keyframe.offset += GetVarint(reader);
+
+        m_keyframes.push_back(keyframe);
+    }
+
+    if (reader.failed) {
+        m_keyframes.clear();
+        return false;
+    }
+
+    m_end      = indexOffset;
+    m_lastTick = lastTick;
+
+    return true;
+}
+
+void StateStreamReader::ScanRecords() {
+    u64 offset = sizeof(StreamHeader);
+
+    u32 type, tick;
+    u64 next;
+
+    while (PeekRecord(offset, type, tick, next)) {
+        if (type == STREAM_KEYFRAME) {
+            m_keyframes.push_back({ tick, offset });
+        }
+
+        m_lastTick = tick;
+        offset = next;
+    }
+}
+
+bool StateStreamReader::PeekRecord(u64 offset, u32& type, u32& tick, u64& next) const {
+    ByteReader reader = { m_file.data, m_end, offset, false };
+
+    u64 size = GetVarint(reader);
+    u64 start = reader.offset;
+
+    // a recording cut off mid record ends at the last whole one
+    if (reader.failed || size > m_end - start) {
+        return false;
+    }
+
+    type = GetByte(reader);
+    tick = (u32)GetVarint(reader);
+    next = start + size;
+
+    return !reader.failed;
+}
+
+bool StateStreamReader::ApplyRecord() {
+    ByteReader reader = { m_file.data, m_end, m_offset, false };
+
+    u64 size = GetVarint(reader);
+
+    if (reader.failed || size > m_end - reader.offset) {
+        return false;
+    }
+
+    reader.size = reader.offset + size;
+
+    u8 type  = GetByte(reader);
+    u32 tick = (u32)GetVarint(reader);
+
+    if (type == STREAM_KEYFRAME) {
+        for (u32 slot = 0; slot < MAX_ENTITY_COUNT; slot++) {
+            m_alive[slot] = false;
+        }
+    }
+    else if (!m_decoded) {
+        // deltas only make sense on top of the records before them
+        return false;
+    }
+
+    u64 removedCount = GetVarint(reader);
+
+    for (u64 i = 0; i < removedCount && !reader.failed; i++) {
+        u64 slot = GetVarint(reader);
+
+        if (slot < MAX_ENTITY_COUNT) {
+            m_alive[slot] = false;
+        }
+    }
+
+    u64 entryCount = GetVarint(reader);
+    u64 slot = 0;
+
+    for (u64 i = 0; i < entryCount && !reader.failed; i++) {
+        slot += GetVarint(reader);
+
+        if (slot >= MAX_ENTITY_COUNT) {
+            return false;
+        }
+
+        u8 fields = GetByte(reader);
+        QuantizedEntity& entity = m_state[slot];
+
+        if (fields & STREAM_SPAWN) {
+            entity = {};
+
+            for (int b = 0; b < 8; b++) {
+                entity.id |= (u64)GetByte(reader) << (b * 8);
+            }
+
+            m_alive[slot] = true;
+        }
+
+        GetFields(reader, fields, entity);
+        slot += 1;
+    }
+
+    if (reader.failed) {
+        return false;
+    }
+
+    m_offset  = reader.size;
+    m_tick    = tick;
+    m_decoded = true;
+
+    return true;
+}
+
+bool StateStreamReader::Seek(u32 tick) {
+    if (m_keyframes.empty() || tick < FirstTick() || tick > m_lastTick) {
+        return false;
+    }
+
+    // last keyframe at or before tick
+    usize low = 0;
+    usize high = m_keyframes.size();
+
+    while (high - low > 1) {
+        usize middle = (low + high) / 2;
+
+        if (m_keyframes[middle].tick <= tick) {
+            low = middle;
+        }
+        else {
+            high = middle;
+        }
+    }
+
+    const StreamKeyframe& keyframe = m_keyframes[low];
+
+    if (!m_decoded || m_tick > tick || m_tick < keyframe.tick) {
+        m_offset  = keyframe.offset;
+        m_decoded = false;
+    }
+
+    u32 type, recordTick;
+    u64 next;
+
+    while (PeekRecord(m_offset, type, recordTick, next)) {
+        if (m_decoded && recordTick > tick) {
+            break;
+        }
+
+        if (!ApplyRecord()) {
+            return false;
+        }
+    }
+
+    m_entities.Clear();
+
+    for (u32 slot = 0; slot < MAX_ENTITY_COUNT; slot++) {
+        if (!m_alive[slot]) {
+            continue;
+        }
+
+        const QuantizedEntity& entity = m_state[slot];
+
+        m_entities.Push({
+            .id       = entity.id,
+            .flags    = entity.flags,
+            .position = { entity.position[0] / STREAM_POSITION_SCALE, entity.position[1] / STREAM_POSITION_SCALE },
+            .size     = { entity.size[0] / STREAM_POSITION_SCALE, entity.size[1] / STREAM_POSITION_SCALE },
+            .velocity = { entity.velocity[0] / STREAM_VELOCITY_SCALE, entity.velocity[1] / STREAM_VELOCITY_SCALE },
+            .rotation = (f32)(i16)entity.rotation * (2.0f * PI / STREAM_ROTATION_STEPS),
+            .pathNext = entity.pathNext,
+            .pathSize = entity.pathSize,
+        });
+    }
+
+    return m_decoded;
+}
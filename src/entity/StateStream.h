@@ -0,0 +1,211 @@
+#ifndef ENTITY_STATE_STREAM_H
+#define ENTITY_STATE_STREAM_H
+
+#include "core/Util.h"
+#include "World.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#define STREAM_MAGIC 0x53444C50 // "PLDS"
+#define STREAM_VERSION 1
+
+// ticks between two keyframes, a seek decodes at most this many records
+#define STREAM_KEYFRAME_INTERVAL 300
+
+// quantisation steps, positions and sizes in 1/16 px, velocities in 1/16 px/s,
+// rotations in 1/65536 of a turn
+#define STREAM_POSITION_SCALE 16.0f
+#define STREAM_VELOCITY_SCALE 16.0f
+#define STREAM_ROTATION_STEPS 65536.0f
+
+// file layout: StreamHeader, then one record per tick, then the keyframe
+// index at indexOffset (0 while recording, or if the recording never closed).
+//
+// record: varint size of the rest, u8 type, varint tick, varint removed
+// count and the removed slots, varint entry count and the entries. an entry
+// is a varint gap to the previous entry's slot, a u8 field mask, the raw id
+// for spawns, then the changed fields as zigzag varint deltas of the
+// quantised values (flags and path progress are written as they are).
+// entities are addressed by a slot the writer hands out, so the 64 bit ids
+// are only written once. a keyframe spawns every entity from nothing
+//
+// index: varint last tick, varint count, then per keyframe a varint tick
+// delta and a varint offset delta
+struct StreamHeader {
+    u32 magic;
+    u32 version;
+    u32 keyframeInterval;
+    u32 reserved;
+    u64 indexOffset;
+};
+
+enum StreamRecordType {
+    STREAM_KEYFRAME,
+    STREAM_DELTA,
+};
+
+// fields of an entry, spawn means the raw id follows and the deltas are from zero
+enum StreamFields {
+    STREAM_FLAGS    = 1 << 0,
+    STREAM_POSITION = 1 << 1,
+    STREAM_ROTATION = 1 << 2,
+    STREAM_SIZE     = 1 << 3,
+    STREAM_VELOCITY = 1 << 4,
+    STREAM_PATH     = 1 << 5,
+    STREAM_SPAWN    = 1 << 7,
+
+    STREAM_ALL_FIELDS = STREAM_FLAGS | STREAM_POSITION | STREAM_ROTATION | STREAM_SIZE | STREAM_VELOCITY | STREAM_PATH,
+};
+
+// the part of an entity that is recorded, as the quantised values both ends agree on
+struct QuantizedEntity {
+    EntityID id;
+    u64 flags;
+    i32 position[2];
+    i32 size[2];
+    i32 velocity[2];
+    u32 rotation;
+    u32 pathNext;
+    u32 pathSize;
+};
+
+// a decoded entity, back in world units
+struct StreamEntity {
+    EntityID id;
+    u64 flags;
+    Vec2 position;
+    Vec2 size;
+    Vec2 velocity;
+    f32 rotation;
+    u32 pathNext;
+    u32 pathSize;
+};
+
+struct StreamKeyframe {
+    u32 tick;
+    u64 offset;
+};
+
+// worst case for one record, every entity spawned with every field at its longest
+#define MAX_STREAM_RECORD_SIZE (64 + (MAX_ENTITY_COUNT * 96))
+
+// records a world tick by tick, only what changed since the last tick
+class StateStreamWriter {
+public:
+    ~StateStreamWriter();
+
+    // a file name, or unix:<path> for a local socket some viewer listens on.
+    // sockets get no index, a viewer picks up from the first keyframe
+    bool Open(const std::string& target, u32 keyframeInterval = STREAM_KEYFRAME_INTERVAL);
+
+    // writes the index, a file is only seekable without a scan once closed
+    void Close();
+
+    bool Active() const {
+        return m_file.is_open() || m_socket != -1;
+    }
+
+    // records the world as of its current tick, call after every RunSystems.
+    // recorded ticks always increase, after a rewind they continue from the last one
+    void WriteTick(const World& world);
+
+    u64 BytesWritten() const {
+        return m_bytesWritten;
+    }
+
+private:
+    void Write(const void* data, usize size);
+
+    std::ofstream m_file;
+    int m_socket = -1;
+
+    u64 m_bytesWritten = 0;
+    u32 m_keyframeInterval = 0;
+    u32 m_lastTick = 0;
+
+    // added to the world tick, moves on when the world goes back in time
+    u32 m_tickBase = 0;
+
+    std::vector<StreamKeyframe> m_keyframes;
+
+    // slot of every recorded entity, slots of destroyed entities are reused
+    Map<EntityID, u32, MAX_ENTITY_COUNT> m_slots;
+    List<u32, MAX_ENTITY_COUNT> m_freeSlots;
+    u32 m_slotCount = 0;
+
+    bool m_alive[MAX_ENTITY_COUNT];
+    bool m_seen[MAX_ENTITY_COUNT];
+    u8 m_fields[MAX_ENTITY_COUNT];
+
+    QuantizedEntity m_previous[MAX_ENTITY_COUNT];
+    QuantizedEntity m_current[MAX_ENTITY_COUNT];
+
+    u8 m_record[MAX_STREAM_RECORD_SIZE];
+};
+
+// reconstructs any recorded tick by decoding forward from the keyframe before it
+class StateStreamReader {
+public:
+    ~StateStreamReader();
+
+    bool Open(const std::string& filename);
+    void Close();
+
+    // the state as of tick, false if the recording does not cover it. seeking
+    // forward from the current tick keeps decoding instead of going back to a keyframe
+    bool Seek(u32 tick);
+
+    u32 Tick() const {
+        return m_tick;
+    }
+
+    u32 FirstTick() const {
+        return m_keyframes.empty() ? 0 : m_keyframes[0].tick;
+    }
+
+    u32 LastTick() const {
+        return m_lastTick;
+    }
+
+    usize KeyframeCount() const {
+        return m_keyframes.size();
+    }
+
+    // the entities of the current tick, ordered by slot
+    const StreamEntity* Entities() const {
+        return m_entities.Data();
+    }
+
+    usize EntityCount() const {
+        return m_entities.Size();
+    }
+
+private:
+    // decodes the record at m_offset, false at the end of the stream or on a broken record
+    bool ApplyRecord();
+
+    // type and tick of the record at offset, and where the next one starts
+    bool PeekRecord(u64 offset, u32& type, u32& tick, u64& next) const;
+
+    bool ReadIndex(u64 indexOffset);
+    void ScanRecords();
+
+    MappedFile m_file = {};
+    u64 m_end = 0;
+
+    std::vector<StreamKeyframe> m_keyframes;
+    u32 m_lastTick = 0;
+
+    u64 m_offset = 0;
+    u32 m_tick = 0;
+    bool m_decoded = false;
+
+    bool m_alive[MAX_ENTITY_COUNT];
+    QuantizedEntity m_state[MAX_ENTITY_COUNT];
+
+    List<StreamEntity, MAX_ENTITY_COUNT> m_entities;
+};
+
+#endif
@@ -1,8 +1,24 @@
 #include "core/Util.h"
 #include "World.h"
 
+World::~World() {
+    m_scratch.Release();
+}
+
+Arena& World::Scratch() {
+    // room for one flag per entity, that is all the world needs scratch for
+    if (m_scratch.Capacity() == 0) {
+        m_scratch.Init(MAX_ENTITY_COUNT * sizeof(bool) + 64);
+    }
+
+    return m_scratch;
+}
+
 EntityData* World::CreateEntity(u64 flags) {
-    EntityID id = Util::RandomID();
+    return AddEntity(m_ids.Next(), flags);
+}
+
+EntityData* World::AddEntity(EntityID id, u64 flags) {
     size_t index = m_entityData.Size();
 
     ASSERT(!m_entityMap.Contains(id));
@@ -10,7 +26,11 @@ EntityData* World::CreateEntity(u64 flags) {
     m_entityMap.Add(id, index);
     m_entityData.Push({ .id = id, .flags = flags });
 
-    return &m_entityData[index];
+    EntityData* entity = &m_entityData[index];
+    ResetSchedule(*entity);
+    MarkDirty(entity, DIRTY_TRANSFORM | DIRTY_SNAP);
+
+    return entity;
 }
 
 void World::DestroyEntity(EntityID entityID) {
@@ -26,10 +46,268 @@ void World::DestroyEntity(EntityID entityID) {
     m_entityMap.Remove(entityID);
 
     m_entityData.QuickRemove(currentIndex);
+    m_collisions.ClearContacts();
+
+    m_spatialGrid.Remove(currentIndex);
+    m_spatialGrid.Move(lastIndex, currentIndex);
+
+    // keep the dirty list pointing at the right slots after the swap
+    for (int i = (int)m_dirtyTransforms.Size() - 1; i >= 0; i--) {
+        if (m_dirtyTransforms[i] == currentIndex) {
+            m_dirtyTransforms.QuickRemove(i);
+        }
+        else if (m_dirtyTransforms[i] == lastIndex) {
+            m_dirtyTransforms[i] = currentIndex;
+        }
+    }
+}
+
+void World::Playback(CommandBuffer& commands) {
+    usize commandCount = commands.Size();
+
+    if (commandCount == 0) {
+        return;
+    }
+
+    usize destroyCount = 0;
+
+    // creates first, so a create and a destroy in the same batch cancel out
+    for (usize i = 0; i < commandCount; i++) {
+        const EntityCommand& command = commands[i];
+
+        if (command.type == COMMAND_CREATE) {
+            EntityData* entity = AddEntity(command.id, command.flags);
+
+            entity->transform = command.init.transform;
+            entity->motion    = command.init.motion;
+            entity->texture   = command.init.texture;
+        }
+    }
+
+    for (usize i = 0; i < commandCount; i++) {
+        const EntityCommand& command = commands[i];
+
+        if (command.type == COMMAND_CREATE) {
+            continue;
+        }
+
+        EntityData* entity = GetEntityData(command.id);
+
+        if (!entity) {
+            continue;
+        }
+
+        switch (command.type) {
+            case COMMAND_ADD_FLAGS:    entity->flags |= command.flags;  break;
+            case COMMAND_REMOVE_FLAGS: entity->flags &= ~command.flags; break;
+            case COMMAND_DESTROY:      destroyCount += 1;               break;
+            default: break;
+        }
+    }
+
+    if (destroyCount == 0) {
+        commands.Clear();
+        return;
+    }
+
+    Arena& arena = Scratch();
+    usize mark = arena.Mark();
+
+    bool* destroyed = arena.Alloc<bool>(m_entityData.Size());
+
+    for (usize i = 0; i < commandCount; i++) {
+        const EntityCommand& command = commands[i];
+
+        if (command.type == COMMAND_DESTROY && m_entityMap.Contains(command.id)) {
+            destroyed[m_entityMap.Get(command.id)] = true;
+        }
+    }
+
+    Compact(destroyed);
+
+    arena.Rewind(mark);
+    commands.Clear();
+}
+
+EntityData* World::CreateEntities(const Prefab& prefab, usize count, EntityID* outIDs) {
+    usize first = m_entityData.Size();
+    ASSERT(first + count <= MAX_ENTITY_COUNT);
+
+    WorldMatrix worldMatrix = {
+        .matrix      = prefab.init.transform.Matrix2D(),
+        .rotation    = prefab.init.transform.rotation,
+        .sinRotation = sinf(prefab.init.transform.rotation),
+        .cosRotation = cosf(prefab.init.transform.rotation),
+    };
+
+    m_entityData.Grow(count);
+    EntityData* entities = &m_entityData[first];
+
+    // field by field, so the large inline path storage is never copied
+    for (usize i = 0; i < count; i++) {
+        EntityData& entity = entities[i];
+
+        entity.id          = m_ids.Next();
+        entity.flags       = prefab.flags;
+        entity.dirty       = DIRTY_TRANSFORM | DIRTY_SNAP;
+        entity.transform   = prefab.init.transform;
+        entity.worldMatrix = worldMatrix;
+        entity.motion      = prefab.init.motion;
+        entity.texture     = prefab.init.texture;
+        entity.path.points.Clear();
+        entity.path.next    = 0;
+        entity.path.version = 0;
+        entity.lodTier      = LOD_NEAR;
+
+        ResetSchedule(entity);
+
+        ASSERT(!m_entityMap.Contains(entity.id));
+        m_entityMap.Add(entity.id, first + i);
+        m_dirtyTransforms.Push(first + i);
+
+        if (outIDs) {
+            outIDs[i] = entity.id;
+        }
+    }
+
+    return entities;
 }
 
-void World::AddSystem(u64 flags, std::function<void(World*, List<EntityID, MAX_ENTITY_COUNT>&)> func) {
-    m_systems.Push({ flags, func });
+void World::DestroyEntities(const EntityID* entityIDs, usize count) {
+    Arena& arena = Scratch();
+    usize mark = arena.Mark();
+
+    bool* destroyed = arena.Alloc<bool>(m_entityData.Size());
+    bool any = false;
+
+    for (usize i = 0; i < count; i++) {
+        if (m_entityMap.Contains(entityIDs[i])) {
+            destroyed[m_entityMap.Get(entityIDs[i])] = true;
+            any = true;
+        }
+    }
+
+    if (any) {
+        Compact(destroyed);
+    }
+
+    arena.Rewind(mark);
+}
+
+void World::Compact(const bool* destroyed) {
+    // survivors slide down and keep their order, the dirty list is rebuilt on the way
+    m_dirtyTransforms.Clear();
+    m_collisions.ClearContacts();
+
+    usize entityCount = m_entityData.Size();
+    usize count = 0;
+
+    for (usize i = 0; i < entityCount; i++) {
+        EntityData& entity = m_entityData[i];
+
+        if (destroyed[i]) {
+            m_entityMap.Remove(entity.id);
+            m_spatialGrid.Remove(i);
+            continue;
+        }
+
+        if (count != i) {
+            m_entityData[count] = entity;
+            m_entityMap.Set(entity.id, count);
+            m_spatialGrid.Move(i, count);
+        }
+
+        if (m_entityData[count].dirty & DIRTY_TRANSFORM) {
+            m_dirtyTransforms.Push(count);
+        }
+
+        count += 1;
+    }
+
+    m_entityData.Truncate(count);
+}
+
+void World::MarkDirty(EntityData* entity, u32 flags) {
+    if ((flags & DIRTY_TRANSFORM) && !(entity->dirty & DIRTY_TRANSFORM)) {
+        m_dirtyTransforms.Push(entity - m_entityData.Data());
+    }
+
+    entity->dirty |= flags;
+}
+
+void World::UpdateTransforms() {
+    for (int i = 0; i < m_dirtyTransforms.Size(); i++) {
+        EntityData& entity = m_entityData[m_dirtyTransforms[i]];
+
+        const Transform& transform = entity.transform;
+        WorldMatrix& worldMatrix   = entity.worldMatrix;
+
+        if (transform.rotation != worldMatrix.rotation) {
+            worldMatrix.rotation    = transform.rotation;
+            worldMatrix.sinRotation = sinf(transform.rotation);
+            worldMatrix.cosRotation = cosf(transform.rotation);
+        }
+
+        worldMatrix.matrix = AffineMatrix(transform.position, transform.size, worldMatrix.sinRotation, worldMatrix.cosRotation);
+
+        if (entity.dirty & DIRTY_SNAP) {
+            worldMatrix.previousPosition = transform.position;
+            worldMatrix.previousSize     = transform.size;
+            worldMatrix.previousSin      = worldMatrix.sinRotation;
+            worldMatrix.previousCos      = worldMatrix.cosRotation;
+        }
+
+        entity.dirty &= ~(DIRTY_TRANSFORM | DIRTY_SNAP);
+
+        if (entity.flags & TRANSFORM) {
+            m_spatialGrid.Update(m_dirtyTransforms[i], BoundingRect(worldMatrix.matrix));
+        }
+    }
+
+    m_dirtyTransforms.Clear();
+}
+
+void World::ResetSchedule(EntityData& entity) {
+    for (int i = 0; i < MAX_SCHEDULED_SYSTEMS; i++) {
+        entity.lastUpdate[i] = m_tick;
+    }
+}
+
+void World::BeginTick(f32 deltaTime) {
+    m_tick += 1;
+    m_tickDeltaTime = deltaTime;
+
+    UpdateTransforms();
+
+    for (usize i = 0; i < m_entityData.Size(); i++) {
+        EntityData& entity = m_entityData[i];
+        WorldMatrix& worldMatrix = entity.worldMatrix;
+
+        worldMatrix.previousPosition = entity.transform.position;
+        worldMatrix.previousSize     = entity.transform.size;
+        worldMatrix.previousSin      = worldMatrix.sinRotation;
+        worldMatrix.previousCos      = worldMatrix.cosRotation;
+    }
+}
+
+void World::AddSystem(SystemFunc func, const UpdateRate& rate) {
+    ASSERT(func);
+
+    bool fullRate = true;
+
+    for (int i = 0; i < LOD_TIER_COUNT; i++) {
+        ASSERT(rate.interval[i] > 0);
+        fullRate = fullRate && (rate.interval[i] == 1);
+    }
+
+    int schedule = -1;
+
+    if (!fullRate) {
+        ASSERT(m_scheduledCount < MAX_SCHEDULED_SYSTEMS);
+        schedule = m_scheduledCount++;
+    }
+
+    m_systems.Push({ .func = func, .rate = rate, .schedule = schedule });
 }
 
 EntityData* World::GetEntityData(EntityID entityID) {
@@ -40,8 +318,8 @@ EntityData* World::GetEntityData(EntityID entityID) {
     return &m_entityData[index];
 }
 
-List<EntityID, MAX_ENTITY_COUNT> World::EntitiesWithFlags(u64 flags) {
-    List<EntityID, MAX_ENTITY_COUNT> result;
+ArenaList<EntityID> World::EntitiesWithFlags(u64 flags, Arena& arena) {
+    ArenaList<EntityID> result(arena, m_entityData.Size());
 
     for (int i = 0; i < m_entityData.Size(); i++) {
         const EntityData& entity = m_entityData[i];
@@ -54,26 +332,105 @@ List<EntityID, MAX_ENTITY_COUNT> World::EntitiesWithFlags(u64 flags) {
     return result;
 }
 
+void World::QueryRect(const Rect& rect, u64 flags, ArenaList<EntityData*>& result) {
+    m_spatialGrid.Query(rect, [&](u32 index) {
+        EntityData& entity = m_entityData[index];
+
+        if ((entity.flags & flags) == flags) {
+            result.Push(&entity);
+        }
+    });
+}
+
+WorldState World::State() const {
+    return {
+        .tick          = m_tick,
+        .tickDeltaTime = m_tickDeltaTime,
+        .idSeed        = m_ids.SeedValue(),
+        .idCounter     = m_ids.Counter(),
+    };
+}
+
+EntityData* World::BeginRestore(usize count) {
+    ASSERT(count <= MAX_ENTITY_COUNT);
+
+    for (usize i = 0; i < m_entityData.Size(); i++) {
+        m_entityMap.Remove(m_entityData[i].id);
+
+        if (m_spatialGrid.Contains(i)) {
+            m_spatialGrid.Remove(i);
+        }
+    }
+
+    m_commands.Clear();
+    m_dirtyTransforms.Clear();
+    m_collisions.ClearContacts();
+
+    // everything derived from the entities is rebuilt in EndRestore
+    m_entityData.Clear();
+    m_entityData.Grow(count);
+
+    return m_entityData.Data();
+}
+
+void World::EndRestore(const WorldState& state) {
+    for (usize i = 0; i < m_entityData.Size(); i++) {
+        EntityData& entity = m_entityData[i];
+        m_entityMap.Add(entity.id, i);
+
+        // the saved world matrix and previous tick state are kept, this only
+        // puts the entity in the grid (and snaps it if it was due to be)
+        u32 dirty = entity.dirty;
+        entity.dirty = 0;
+
+        MarkDirty(&entity, DIRTY_TRANSFORM | (dirty & DIRTY_SNAP));
+    }
+
+    m_ids.Restore(state.idSeed, state.idCounter);
+    m_tick          = state.tick;
+    m_tickDeltaTime = state.tickDeltaTime;
+
+    UpdateTransforms();
+}
+
+u64 HashEntity(u64 hash, const EntityData& entity) {
+    // field by field, struct padding is not part of the state
+    hash = Util::HashBytes(hash, &entity.id, sizeof(entity.id));
+    hash = Util::HashBytes(hash, &entity.flags, sizeof(entity.flags));
+    hash = Util::HashBytes(hash, &entity.transform.position, sizeof(entity.transform.position));
+    hash = Util::HashBytes(hash, &entity.transform.size, sizeof(entity.transform.size));
+    hash = Util::HashBytes(hash, &entity.transform.rotation, sizeof(entity.transform.rotation));
+    hash = Util::HashBytes(hash, &entity.motion, sizeof(entity.motion));
+    hash = Util::HashBytes(hash, entity.path.points.Data(), entity.path.points.Size() * sizeof(Vec2));
+    hash = Util::HashBytes(hash, &entity.path.next, sizeof(entity.path.next));
+
+    return hash;
+}
+
+u64 World::Hash() const {
+    u64 hash = Util::HASH_SEED;
+
+    for (usize i = 0; i < m_entityData.Size(); i++) {
+        hash = HashEntity(hash, m_entityData[i]);
+    }
+
+    return hash;
+}
+
 void World::RunSystems() {
     for (int i = 0; i < m_systems.Size(); i++) {
-        const System& system = m_systems[i];
+        // systems only ever see up to date world matrices
+        UpdateTransforms();
 
-        List<EntityID, MAX_ENTITY_COUNT> entities;
-        
-        for (int i = 0; i < m_entityData.Size(); i++) {
-            const EntityData& entity = m_entityData[i];
+        m_schedule = m_systems[i].schedule;
+        m_rate     = &m_systems[i].rate;
 
-            if ((entity.flags & system.flags) == system.flags) {
-                entities.Push(entity.id);
-            }
-        }
+        m_systems[i].func(this);
 
-        if (entities.Empty()) {
-            continue;
-        }
+        m_schedule = -1;
+        m_rate     = NULL;
 
-        if (system.func) {
-            system.func(this, entities);
-        }
+        // sync point, structural changes recorded by the system land here
+        Playback(m_commands);
     }
 }
\ No newline at end of file
@@ -1,37 +1,256 @@
 #ifndef ENTITY_WORLD_H
 #define ENTITY_WORLD_H
 
+#include "Collision.h"
+#include "CommandBuffer.h"
 #include "Entity.h"
 #include "Map.h"
+#include "SpatialGrid.h"
 
-#include <functional>
+#include <type_traits>
 
 #define MAX_SYSTEM_COUNT 256
 
 class World;
 
+// systems pull their entities through World::Each, so all a system needs is the world
+typedef void (*SystemFunc)(World* world);
+
+// ticks between two updates of an entity, per LOD tier
+struct UpdateRate {
+    u32 interval[LOD_TIER_COUNT];
+};
+
+inline constexpr UpdateRate FULL_RATE = {{ 1, 1, 1 }};
+
 struct System {
-    u64 flags;
-    std::function<void(World*, List<EntityID, MAX_ENTITY_COUNT>&)> func;
+    SystemFunc func;
+    UpdateRate rate;
+
+    // slot in EntityData::lastUpdate, -1 for systems that run at the full rate
+    int schedule;
+};
+
+// what a snapshot needs besides the entities to continue a world exactly
+struct WorldState {
+    u32 tick;
+    f32 tickDeltaTime;
+    u64 idSeed;
+    u64 idCounter;
 };
 
+// World::Hash chains this over every entity starting from Util::HASH_SEED,
+// so entities that are not in a world yet can be checked against it
+u64 HashEntity(u64 hash, const EntityData& entity);
+
+// everything a simulation touches lives in its world, ids, scratch memory
+// and the context the systems read, so any number of worlds can step in
+// parallel on different threads
 class World {
 public:
+    World() = default;
+    ~World();
+
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+
+    // entity ids are derived from the seed, same seed and same sequence of
+    // creates give the same ids
+    void SetSeed(u64 seed) {
+        m_ids.Seed(seed);
+    }
+
+    // whatever the systems need beyond the entities, owned by the caller
+    void SetContext(void* context) {
+        m_context = context;
+    }
+
+    template<typename T>
+    T& Context() {
+        ASSERT(m_context);
+        return *(T*)m_context;
+    }
+
+    // immediate structural changes, these move entities around in memory
+    // and must not be used while a system is iterating
     EntityData* CreateEntity(u64 flags);
     void DestroyEntity(EntityID entityID);
 
-    void AddSystem(u64 flags, std::function<void(World*, List<EntityID, MAX_ENTITY_COUNT>&)> func);
+    // count entities cloned from prefab, stored contiguously. returns the
+    // first one so the caller can initialise the whole range in one loop
+    EntityData* CreateEntities(const Prefab& prefab, usize count, EntityID* outIDs = NULL);
+    void DestroyEntities(const EntityID* entityIDs, usize count);
+
+    // deferred structural changes, played back between systems
+    CommandBuffer& Commands() {
+        return m_commands;
+    }
+
+    // applies every command in one batch and clears the buffer. all the
+    // destroys share a single compaction pass over the entity array
+    void Playback(CommandBuffer& commands);
+
+    // a system with a reduced rate sees each entity only on some ticks,
+    // see EachDue
+    void AddSystem(SystemFunc func, const UpdateRate& rate = FULL_RATE);
+
+    // must be called after changing an entity's transform, the world
+    // matrix is only recomputed for entities marked DIRTY_TRANSFORM
+    void MarkDirty(EntityData* entity, u32 flags);
+    void UpdateTransforms();
+
+    // call before every simulation tick, keeps the transforms the tick
+    // starts from so rendering can interpolate towards the new ones
+    void BeginTick(f32 deltaTime);
+
+    u32 Tick() const {
+        return m_tick;
+    }
+
+    f32 TickDeltaTime() const {
+        return m_tickDeltaTime;
+    }
 
     EntityData* GetEntityData(EntityID entityID);
-    List<EntityID, MAX_ENTITY_COUNT> EntitiesWithFlags(u64 flags);
+    ArenaList<EntityID> EntitiesWithFlags(u64 flags, Arena& arena = Memory::FrameArena());
+
+    // entities with all of flags whose bounds overlap rect, answered by the spatial grid
+    void QueryRect(const Rect& rect, u64 flags, ArenaList<EntityData*>& result);
+
+    usize EntityCount() const {
+        return m_entityData.Size();
+    }
+
+    // every entity in storage order, EntityCount() of them
+    EntityData* Entities() {
+        return m_entityData.Data();
+    }
+
+    const EntityData* Entities() const {
+        return m_entityData.Data();
+    }
+
+    // contacts index Entities(), destroys and Restore clear them since they move entities
+    CollisionDetector& Collisions() {
+        return m_collisions;
+    }
+
+    WorldState State() const;
+
+    // replaces every entity with count saved ones and continues from state,
+    // read(index, entity) fills in each one in place. systems, seed and
+    // context stay, pending commands are dropped
+    template<typename F>
+    void Restore(const WorldState& state, usize count, F&& read) {
+        EntityData* entities = BeginRestore(count);
+
+        for (usize i = 0; i < count; i++) {
+            read(i, entities[i]);
+        }
+
+        EndRestore(state);
+    }
+
+    // hash of the simulated state of every entity, in storage order. two
+    // runs of the same build with the same input produce the same hash
+    u64 Hash() const;
 
     void RunSystems();
 
+    // calls fn for every entity that has all of Cs, either as fn(Cs&...) or
+    // as fn(EntityData&, Cs&...). the flag mask and the component offsets are
+    // compile time constants, so the loop is a plain walk over m_entityData
+    template<typename... Cs, typename F>
+    void Each(F&& fn) {
+        constexpr u64 flags = (Component<Cs>::flag | ... | 0);
+
+        EntityData* entities = m_entityData.Data();
+        usize count = m_entityData.Size();
+
+        for (usize i = 0; i < count; i++) {
+            EntityData& entity = entities[i];
+
+            if ((entity.flags & flags) != flags) {
+                continue;
+            }
+
+            if constexpr (std::is_invocable_v<F, EntityData&, Cs&...>) {
+                fn(entity, Component<Cs>::Get(entity)...);
+            }
+            else {
+                fn(Component<Cs>::Get(entity)...);
+            }
+        }
+    }
+
+    // Each for the running system's rate. an entity is due on the ticks of
+    // its tier's interval, offset by its id so a tier is spread evenly over
+    // the interval instead of all updating on the same tick. fn gets one more
+    // argument, the time since this system last updated the entity
+    template<typename... Cs, typename F>
+    void EachDue(F&& fn) {
+        Each<Cs...>([&](EntityData& entity, Cs&... components) {
+            f32 deltaTime = m_tickDeltaTime;
+
+            if (m_schedule >= 0) {
+                u32 interval = m_rate->interval[entity.lodTier];
+
+                if ((m_tick + (u32)entity.id) % interval != 0) {
+                    return;
+                }
+
+                deltaTime = (f32)(m_tick - entity.lastUpdate[m_schedule]) * m_tickDeltaTime;
+                entity.lastUpdate[m_schedule] = m_tick;
+            }
+
+            if constexpr (std::is_invocable_v<F, EntityData&, Cs&..., f32>) {
+                fn(entity, components..., deltaTime);
+            }
+            else {
+                fn(components..., deltaTime);
+            }
+        });
+    }
+
 private:
+    EntityData* AddEntity(EntityID id, u64 flags);
+
+    // nothing has run yet, every scheduled system counts from now
+    void ResetSchedule(EntityData& entity);
+
+    // Restore in two halves, the entities are read in between
+    EntityData* BeginRestore(usize count);
+    void EndRestore(const WorldState& state);
+
+    // removes every entity whose index is flagged in destroyed, keeping the order of the rest
+    void Compact(const bool* destroyed);
+
+    // per world scratch memory instead of the frame arena, which belongs to the main thread
+    Arena& Scratch();
+
     Map<EntityID, usize, MAX_ENTITY_COUNT> m_entityMap;
 
     List<EntityData, MAX_ENTITY_COUNT> m_entityData;
+    List<usize, MAX_ENTITY_COUNT> m_dirtyTransforms;
+
+    SpatialGrid m_spatialGrid;
+    CollisionDetector m_collisions;
+
+    EntityIDGenerator m_ids;
+    CommandBuffer m_commands { m_ids };
+
+    Arena m_scratch;
+    void* m_context = NULL;
+
     List<System, MAX_SYSTEM_COUNT> m_systems;
+    int m_scheduledCount = 0;
+
+    u32 m_tick = 0;
+    f32 m_tickDeltaTime = 0;
+
+    // the system RunSystems is inside of
+    int m_schedule = -1;
+    const UpdateRate* m_rate = NULL;
 };
 
 #endif
\ No newline at end of file
@@ -1,164 +1,238 @@
 #include "core/Application.h"
+#include "core/Input.h"
+#include "core/Jobs.h"
+#include "core/Memory.h"
+#include "core/Random.h"
+#include "core/renderer/DebugDraw.h"
+#include "core/renderer/NullBackend.h"
 #include "core/renderer/Renderer2D.h"
 #include "core/renderer/Texture.h"
 #include "core/renderer/Shader.h"
+#include "core/renderer/SoftwareBackend.h"
+#include "core/renderer/Tilemap.h"
 #include "entity/Entity.h"
 #include "entity/World.h"
 #include "game.h"
+#include "Scenario.h"
 
-#include <format>
+#include <fstream>
 #include <iostream>
-#include <random>
+#include <memory>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include <vector>
 
 #include <imgui.h>
 #include <SDL.h>
 
-void MotionSystem(World* world, List<EntityID, MAX_ENTITY_COUNT>& entities) {
-    Vec2 windowSize = Application::WindowSize();
-    const TimeStep& timeStep = Application::FrameTime();
-    
-    for (int i = 0; i < entities.Size(); i++) {
-        EntityData* entity = world->GetEntityData(entities[i]);
+// room around the view for the debug lines that stick out of the sprites
+static constexpr f32 CULL_MARGIN = 128.0f;
 
-        if (!entity) {
-            continue;
-        }
+// entities this far outside the view are background traffic
+static constexpr f32 LOD_MID_MARGIN = 1024.0f;
 
-        Transform& transform = entity->transform;
-        Motion& motion       = entity->motion;
+// --snapshot, the world starts from this instead of a single plane
+static const char* m_startSnapshot = NULL;
 
-        motion.velocity    += motion.acceleration * timeStep.DeltaTime();
-        transform.position += motion.velocity * timeStep.DeltaTime();
+// --stream, a file or unix:<path> every tick is recorded to
+static const char* m_streamTarget = NULL;
 
-        if (transform.position.x < 0 || transform.position.x > windowSize.x) {
-            motion.velocity.x = -motion.velocity.x;
-        }
+// the ship sprites face up, the transform rotation follows the velocity
+static const Mat3x2 SPRITE_ROTATION = RotationMatrix(PI / 2);
 
-        if (transform.position.y < 0 || transform.position.y > windowSize.y) {
-            motion.velocity.y = -motion.velocity.y;
-        }
+// fewer sprites than this per thread are not worth handing out
+static constexpr usize SPRITE_CHUNK_SIZE = 256;
 
-        transform.rotation = motion.velocity.Angle();
-    }
-}
+// not a world system, it runs once per frame after however many ticks were due
+void RenderSystem(World* world, f32 alpha) {
+    const Camera2D& camera = m_gameState.camera;
 
-void PathSystem(World* world, List<EntityID, MAX_ENTITY_COUNT>& entities) {
-    for (int i = 0; i < entities.Size(); i++) {
-        EntityData* entity = world->GetEntityData(entities[i]);
+    Renderer2D::Begin(camera);
+    Renderer2D::Clear({ 0.25f, 0.25f, 0.25f, 1.0f });
+    Renderer2D::DrawTilemap(m_gameState.background, camera);
 
-        if (!entity) {
-            continue;
-        }
+    // only what the camera can see is submitted
+    ArenaList<EntityData*> visible(Memory::FrameArena(), world->EntityCount());
+    world->QueryRect(camera.VisibleRect(CULL_MARGIN), TRANSFORM | MOTION | SPRITE | PATH, visible);
 
-        Transform& transform = entity->transform;
-        Motion& motion = entity->motion;
-        List<Vec2, MAX_PATH_SIZE>& path = entity->path;
+    // one builder per chunk rather than per thread, so the merged order never
+    // depends on which thread ran which chunk
+    u32 chunkCount = Jobs::ChunkCount(visible.Size(), SPRITE_CHUNK_SIZE);
+    Renderer2D::BatchBuilder* builders = Memory::FrameArena().Alloc<Renderer2D::BatchBuilder>(chunkCount);
 
-        if (path.Size() < 2) {
-            motion.acceleration = {};
-            motion.velocity = motion.velocity.Normalized() * 75;
-            continue;
+    for (u32 i = 0; i < chunkCount; i++) {
+        usize first = (visible.Size() * i) / chunkCount;
+        usize last  = (visible.Size() * (i + 1)) / chunkCount;
+
+        builders[i] = Renderer2D::CreateBatchBuilder(last - first);
+    }
+
+    Jobs::ParallelFor(visible.Size(), chunkCount, [&](usize first, usize last, u32 chunk) {
+        for (usize i = first; i < last; i++) {
+            const EntityData* entity = visible[i];
+            Renderer2D::BatchTexture(builders[chunk], entity->texture, InterpolatedMatrix(*entity, alpha) * SPRITE_ROTATION, WHITE);
         }
+    });
+
+    for (u32 i = 0; i < chunkCount; i++) {
+        Renderer2D::SubmitBatch(builders[i]);
+    }
 
-        Vec2 targetPoint = path[0];
-        Vec2 moveVector  = targetPoint - transform.position;
+    EntityData* selected = world->GetEntityData(m_gameState.selectedEntity);
 
-        //TODO: the position of this entity, is actually at the 
-        //      center of any texture that we may draw. we should 
-        //      move on to the next point if the target point is within 
-        //      the rect that contains the texture (i.e. use tranform.size)
-        if (moveVector.Length() <= m_gameState.tileSize * 2) {
-            path.Remove(0);
+    if (selected) {
+        Mat3x2 matrix = InterpolatedMatrix(*selected, alpha);
+        DrawEntityLabel(*selected, { matrix.m02, matrix.m12 });
+    }
 
-            targetPoint = path[0];
-            moveVector = targetPoint - transform.position;
+    // debug visuals go on top of every sprite
+    if (DebugDraw::Enabled(DEBUG_PATHS)) {
+        for (int i = 0; i < visible.Size(); i++) {
+            DebugDrawPath(*visible[i]);
         }
-
-        Vec2 targetVelocity = moveVector.Normalized() * 75;
-        motion.acceleration = targetVelocity - motion.velocity;
     }
-}
 
-void RenderSystem(World* world, List<EntityID, MAX_ENTITY_COUNT>& entities) {
-    Renderer2D::Begin();
-    Renderer2D::Clear({ 0.25f, 0.25f, 0.25f, 1.0f });
-    
-    for (int i = 0; i < entities.Size(); i++) {
-        EntityData* entity = world->GetEntityData(entities[i]);
+    if (DebugDraw::Enabled(DEBUG_BOUNDS | DEBUG_MOTION)) {
+        for (int i = 0; i < visible.Size(); i++) {
+            const EntityData* entity = visible[i];
+
+            Mat3x2 matrix = InterpolatedMatrix(*entity, alpha);
+            Vec2 position = { matrix.m02, matrix.m12 };
+            const Motion& motion = entity->motion;
 
-        if (!entity) {
-            continue;
+            DebugDraw::RectLines(DEBUG_BOUNDS, matrix, GREEN);
+            DebugDraw::Line(DEBUG_MOTION, position, position + motion.acceleration, { 1, 0, 1, 1 });
+            DebugDraw::Line(DEBUG_MOTION, position, position + motion.velocity, BLUE);
         }
+    }
+
+    // every pair the last tick resolved, with the normal scaled up to be visible
+    if (DebugDraw::Enabled(DEBUG_COLLISION)) {
+        const CollisionDetector& collisions = world->Collisions();
+        const EntityData* entities = world->Entities();
 
-        const Transform& transform = entity->transform;
-        const Motion& motion = entity->motion;
-        const List<Vec2, MAX_PATH_SIZE>& path = entity->path;
-        const Texture2D& texture = entity->texture;
+        for (usize i = 0; i < collisions.ContactCount(); i++) {
+            const Contact& contact = collisions.Contacts()[i];
 
-        DebugDrawPath(entities[i]);
+            Mat3x2 a = InterpolatedMatrix(entities[contact.a], alpha);
+            Mat3x2 b = InterpolatedMatrix(entities[contact.b], alpha);
 
-        SDL_FRect rect = {
-            transform.position.x - (transform.size.x / 2.0f),
-            transform.position.y - (transform.size.y / 2.0f),
-            transform.size.x,
-            transform.size.y,
-        };
+            Vec2 middle = { (a.m02 + b.m02) * 0.5f, (a.m12 + b.m12) * 0.5f };
 
-        Renderer2D::DrawTexture(texture, { transform.position, transform.size, transform.rotation + (PI / 2) }, WHITE);
-        
-        // debug
-        {
-            Renderer2D::DrawRectLines(transform, GREEN);
-            Renderer2D::DrawLine(transform.position, transform.position + motion.acceleration, {1, 0, 1, 1 });
-            Renderer2D::DrawLine(transform.position, transform.position + motion.velocity, BLUE);
+            DebugDraw::RectLines(DEBUG_COLLISION, a, RED);
+            DebugDraw::RectLines(DEBUG_COLLISION, b, RED);
+            DebugDraw::Line(DEBUG_COLLISION, middle, middle + contact.normal * 16.0f, { 1, 1, 0, 1 });
         }
     }
 
+    DebugDraw::Flush();
     Renderer2D::End();
 }
 
 void OnInit() {
-    m_gameState.world.AddSystem(TRANSFORM | MOTION | PATH, PathSystem);
-    m_gameState.world.AddSystem(TRANSFORM | MOTION, MotionSystem);
-    m_gameState.world.AddSystem(TRANSFORM | MOTION | SPRITE | PATH, RenderSystem);
+    m_gameState.sim = {
+        .arrivalRadius = (f32)m_gameState.tileSize * 2,
+        .cruiseSpeed   = 75,
+        .parallel      = true,
+    };
+
+    m_gameState.world.SetSeed(Random::Seed());
+    m_gameState.world.SetContext(&m_gameState.sim);
+    AddSimulationSystems(m_gameState.world);
+
+    RegisterActions();
 
     Vec2 windowSize = Application::WindowSize();
+    m_gameState.camera.viewportSize = windowSize;
 
-    srand(time(NULL));
+    Renderer2D::LoadFont(m_gameState.font, "data/fonts/DejaVuSansMono.ttf", 16.0f);
 
-    for (int i = 0; i < 1; i++) {
-        EntityData* entity = m_gameState.world.CreateEntity(TRANSFORM | MOTION | SPRITE | PATH);
+    {
+        static constexpr u16 GRASS_TILE = 110;
+        static constexpr u32 MAP_SIZE   = 128;
 
-        entity->transform.position.x = (rand() % (int)windowSize.x - 32) + 32;
-        entity->transform.position.y = (rand() % (int)windowSize.y - 32) + 32;
+        Texture2D tileset = Renderer2D::LoadTexture("data/kenney_pixel-shmup/Tilemap/tiles_packed.png");
+        Renderer2D::InitTilemap(m_gameState.background, tileset, 16, 32.0f, MAP_SIZE, MAP_SIZE);
 
-        entity->transform.size.x = 80;
-        entity->transform.size.y = 80;
+        for (u32 y = 0; y < MAP_SIZE; y++) {
+            for (u32 x = 0; x < MAP_SIZE; x++) {
+                Renderer2D::SetTile(m_gameState.background, x, y, GRASS_TILE);
+            }
+        }
+    }
+
+    m_gameState.random = Random::Stream(Random::Seed(), Random::SIMULATION_STREAM);
 
-        f32 angle = (rand() % 360) * DEG_TO_RAD;
+    m_gameState.planePrefab = {
+        .flags = TRANSFORM | MOTION | SPRITE | PATH | COLLIDER,
+        .init  = {
+            .transform = { .size = { 80, 80 } },
+            .texture   = Renderer2D::LoadTexture("data/kenney_pixel-shmup/Ships/ship_0000.png"),
+        },
+    };
 
-        entity->motion.velocity.x = 75 * cosf(angle);
-        entity->motion.velocity.y = 75 * sinf(angle);
+    if (!m_startSnapshot || !Snapshot::Load(m_gameState.world, m_startSnapshot)) {
+        SpawnPlanes(1);
+    }
 
-        entity->texture = Renderer2D::LoadTexture("data/kenney_pixel-shmup/Ships/ship_0000.png");
+    if (m_streamTarget) {
+        m_gameState.stream.Open(m_streamTarget);
     }
 }
 
 void OnUpdate(const TimeStep& timeStep) {
-    Application::SetWindowTitle(std::format("FrameTime: {} ms", timeStep.DeltaTimeMS()));
-    
     ImGuiIO& io = ImGui::GetIO();
 
     if (m_gameState.canDrawPath) {
         io.WantCaptureMouse = false;
     }
 
+    if (!io.WantCaptureKeyboard) {
+        UpdateCamera(timeStep.DeltaTime());
+
+        if (Input::ActionPressed(m_gameState.actions.destroy)) {
+            m_gameState.world.Commands().Destroy(m_gameState.selectedEntity);
+        }
+
+        if (Input::ActionPressed(m_gameState.actions.spawnWave)) {
+            SpawnPlanes(WAVE_SIZE);
+        }
+
+        if (Input::ActionPressed(m_gameState.actions.saveSnapshot) && !m_gameState.snapshotWriter.Active()) {
+            m_gameState.snapshotWriter.Begin(m_gameState.world, QUICKSAVE_FILE);
+        }
+
+        if (Input::ActionPressed(m_gameState.actions.loadSnapshot)) {
+            Snapshot::Load(m_gameState.world, QUICKSAVE_FILE);
+        }
+    }
+
     if (!io.WantCaptureMouse) {
         UpdateInputState();
         PlacePathPoint();
     }
 
-    m_gameState.world.RunSystems();
+    m_gameState.snapshotWriter.Step(SNAPSHOT_SLICE_SIZE);
+
+    // everything the camera can see (and the selection) is near
+    SimSettings& sim = m_gameState.sim;
+    sim.bounds      = Application::WindowSize();
+    sim.focus       = m_gameState.camera.VisibleRect(CULL_MARGIN);
+    sim.nearby      = m_gameState.camera.VisibleRect(LOD_MID_MARGIN);
+    sim.focusEntity = m_gameState.selectedEntity;
+
+    // the simulation runs at the tick rate, rendering at whatever the display does
+    for (u32 i = 0; i < timeStep.FixedSteps(); i++) {
+        m_gameState.world.BeginTick(timeStep.FixedDeltaTime());
+        m_gameState.world.RunSystems();
+        m_gameState.stream.WriteTick(m_gameState.world);
+    }
+
+    m_gameState.world.UpdateTransforms();
+    RenderSystem(&m_gameState.world, timeStep.Alpha());
+
+    DrawHUD(timeStep);
 
     Application::ImGuiNewFrame();
 
@@ -178,9 +252,149 @@ void OnUpdate(const TimeStep& timeStep) {
     
     ImGui::End();
 
+    ImGui::Begin("Stats");
+
+    const Arena& frameArena = Memory::FrameArena();
+    ImGui::Text("Frame arena: %zu KB used, %zu KB peak, %zu KB capacity", frameArena.Used() / 1024, frameArena.Peak() / 1024, frameArena.Capacity() / 1024);
+    ImGui::Text("Input latency: %u ms", Input::LatchLatency());
+
+    if (m_gameState.snapshotWriter.Active()) {
+        ImGui::Text("Saving snapshot: %.0f%%", m_gameState.snapshotWriter.Progress() * 100.0f);
+    }
+    ImGui::Text("Contacts: %zu%s", m_gameState.world.Collisions().ContactCount(), m_gameState.world.Collisions().Overflowed() ? " (overflowed)" : "");
+    ImGui::Text("LOD: %u near, %u mid, %u far", sim.lodCounts[LOD_NEAR], sim.lodCounts[LOD_MID], sim.lodCounts[LOD_FAR]);
+
+    {
+        const f32* history = timeStep.History();
+        f32 maxFrameMS = 0;
+
+        for (u32 i = 0; i < FRAME_HISTORY_SIZE; i++) {
+            maxFrameMS = (history[i] > maxFrameMS) ? history[i] : maxFrameMS;
+        }
+
+        char overlay[64];
+        snprintf(overlay, sizeof(overlay), "%.2f ms smoothed, %.2f ms max", timeStep.DeltaTimeMS(), maxFrameMS);
+
+        ImGui::PlotLines("Frame time", history, FRAME_HISTORY_SIZE, timeStep.HistoryOffset(), overlay, 0.0f, 33.3f, ImVec2(0, 60));
+    }
+
+#if DEBUG_DRAW
+    ImGui::Separator();
+    ImGui::Text("Debug draw");
+
+    for (u32 i = 0; i < DEBUG_CATEGORY_COUNT; i++) {
+        bool enabled = DebugDraw::Enabled(1 << i);
+
+        if (ImGui::Checkbox(DebugDraw::CategoryName(i), &enabled)) {
+            DebugDraw::SetEnabled(1 << i, enabled);
+        }
+    }
+#endif
+
+    ImGui::End();
+
     Application::ImGuiRender();
 }
 
+// simulation ticks per second, rendering interpolates between them
+static constexpr f32 SIMULATION_RATE = 30.0f;
+
+// channel difference allowed against a golden image
+static constexpr int GOLDEN_TOLERANCE = 2;
+
+// compares the last software frame against the golden image, or writes it if
+// there is none yet. returns non zero when the frame does not match
+static int CheckGolden(const char* filename) {
+    if (!std::ifstream(filename).good()) {
+        std::cout << "Golden: writing " << filename << std::endl;
+        return Renderer2D::WriteFramebuffer(filename) ? 0 : 1;
+    }
+
+    int difference = Renderer2D::CompareFramebuffer(filename);
+
+    if (difference < 0 || difference > GOLDEN_TOLERANCE) {
+        std::cout << "ERROR: Frame does not match " << filename << " (max channel difference " << difference << ")" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Golden: " << filename << " matches (max channel difference " << difference << ")" << std::endl;
+    return 0;
+}
+
+static void PrintRenderStats() {
+    const RenderStats& stats = Renderer2D::NullTotalStats();
+    f64 frames = stats.frames ? (f64)stats.frames : 1.0;
+
+    std::cout << "Render: " << stats.frames << " frames, per frame: "
+              << stats.drawCalls / frames << " draw calls, "
+              << stats.vertices / frames << " vertices, "
+              << stats.textureBinds / frames << " texture binds, "
+              << stats.bytesUploaded / frames / 1024.0 << " KB uploaded" << std::endl;
+}
+
+// headless, no window or renderer, every scenario is its own world
+static int RunScenarios(u64 seed, u32 count, u32 threadCount) {
+    ScenarioDesc desc = {
+        .seed          = seed,
+        .count         = count,
+        .planeCount    = 256,
+        .waypointCount = 8,
+        .ticks         = (u32)(SIMULATION_RATE * 120),
+        .tickRate      = SIMULATION_RATE,
+        .bounds        = { 1280, 720 },
+    };
+
+    Jobs::Init(threadCount);
+    threadCount = Jobs::ThreadCount();
+
+    std::vector<ScenarioResult> results(count);
+    ScenarioSummary summary = Scenario::RunBatch(desc, results.data());
+
+    Jobs::Shutdown();
+
+    std::cout << "Scenarios:    " << summary.scenarios << " on " << threadCount << " threads in " << summary.wallTime << " s" << std::endl;
+    std::cout << "Routes:       " << summary.routesCompleted << " of " << summary.routes << " completed" << std::endl;
+    std::cout << "Completion:   " << summary.meanCompletionTime << " s mean, "
+              << summary.minCompletionTime << " - " << summary.maxCompletionTime << " s per scenario" << std::endl;
+    std::cout << "Batch hash:   " << std::hex << summary.batchHash << std::dec << std::endl;
+
+    return 0;
+}
+
+// prints the entities of a recorded tick, the last one if tick is 0
+static int InspectStream(const char* filename, u32 tick) {
+    std::unique_ptr<StateStreamReader> reader = std::make_unique<StateStreamReader>();
+
+    if (!reader->Open(filename)) {
+        return 1;
+    }
+
+    std::cout << "Ticks:        " << reader->FirstTick() << " - " << reader->LastTick() << ", " << reader->KeyframeCount() << " keyframes" << std::endl;
+
+    if (tick == 0) {
+        tick = reader->LastTick();
+    }
+
+    if (!reader->Seek(tick)) {
+        std::cout << "ERROR: Tick " << tick << " is not in the stream" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Tick " << reader->Tick() << ": " << reader->EntityCount() << " entities" << std::endl;
+
+    for (usize i = 0; i < reader->EntityCount(); i++) {
+        const StreamEntity& entity = reader->Entities()[i];
+
+        std::cout << std::hex << entity.id << std::dec
+                  << " position " << entity.position.x << ", " << entity.position.y
+                  << " velocity " << entity.velocity.x << ", " << entity.velocity.y
+                  << " rotation " << entity.rotation
+                  << " path " << entity.pathNext << "/" << entity.pathSize << std::endl;
+    }
+
+    return 0;
+}
+
 int main(int argc, char** argv) {
     AppDesc desc = {
         .windowWidth  = 1280,
@@ -188,9 +402,113 @@ int main(int argc, char** argv) {
         .windowTitle  = "PLANE",
     };
 
+    desc.fixedTimeStep = 1.0f / SIMULATION_RATE;
+
+    u64 seed = (u64)time(NULL);
+    const char* goldenFile = NULL;
+    u32 scenarioCount = 0;
+
+    const char* inspectFile = NULL;
+    u32 inspectTick = 0;
+
+    // --seed <n>, --record <file>, --replay <file>, --headless,
+    // --fps <n>, --no-vsync, --threads <n>, --backend gl|software|null, --golden <png> (software only, pair it with a replay),
+    // --scenarios <n> (runs a headless batch and exits), --snapshot <file> (starts from a saved world),
+    // --stream <file|unix:path> (records every tick), --inspect-stream <file> [--tick <n>] (prints a recorded tick and exits)
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = (i + 1 < argc);
+
+        if (strcmp(argv[i], "--seed") == 0 && hasValue) {
+            seed = strtoull(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--record") == 0 && hasValue) {
+            desc.recordFile = argv[++i];
+        }
+        else if (strcmp(argv[i], "--replay") == 0 && hasValue) {
+            desc.replayFile = argv[++i];
+            desc.headless   = true;
+        }
+        else if (strcmp(argv[i], "--headless") == 0) {
+            desc.headless = true;
+        }
+        else if (strcmp(argv[i], "--fps") == 0 && hasValue) {
+            desc.frameRateLimit = (u32)strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--no-vsync") == 0) {
+            desc.disableVsync = true;
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && hasValue) {
+            desc.threadCount = (u32)strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--backend") == 0 && hasValue) {
+            const char* backend = argv[++i];
+
+            if (strcmp(backend, "software") == 0) {
+                desc.renderBackend = Renderer2D::RENDER_BACKEND_SOFTWARE;
+            }
+            else if (strcmp(backend, "null") == 0) {
+                desc.renderBackend = Renderer2D::RENDER_BACKEND_NULL;
+            }
+            else if (strcmp(backend, "gl") != 0) {
+                std::cout << "ERROR: Unknown backend: " << backend << std::endl;
+            }
+        }
+        else if (strcmp(argv[i], "--golden") == 0 && hasValue) {
+            goldenFile = argv[++i];
+        }
+        else if (strcmp(argv[i], "--stream") == 0 && hasValue) {
+            m_streamTarget = argv[++i];
+        }
+        else if (strcmp(argv[i], "--inspect-stream") == 0 && hasValue) {
+            inspectFile = argv[++i];
+        }
+        else if (strcmp(argv[i], "--tick") == 0 && hasValue) {
+            inspectTick = (u32)strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--snapshot") == 0 && hasValue) {
+            m_startSnapshot = argv[++i];
+        }
+        else if (strcmp(argv[i], "--scenarios") == 0 && hasValue) {
+            scenarioCount = (u32)strtoul(argv[++i], NULL, 10);
+        }
+        else {
+            std::cout << "ERROR: Unknown argument: " << argv[i] << std::endl;
+        }
+    }
+
+    if (inspectFile) {
+        return InspectStream(inspectFile, inspectTick);
+    }
+
+    if (scenarioCount > 0) {
+        return RunScenarios(seed, scenarioCount, desc.threadCount);
+    }
+
+    Random::SetSeed(seed);
+
     Application::Init(desc);
+    Application::SetStateHashCallback([]() { return m_gameState.world.Hash(); });
     Application::Run(OnInit, OnUpdate);
+
+    m_gameState.stream.Close();
+
+    int exitCode = Application::ExitCode();
+
+    if (goldenFile) {
+        if (desc.renderBackend == Renderer2D::RENDER_BACKEND_SOFTWARE) {
+            exitCode |= CheckGolden(goldenFile);
+        }
+        else {
+            std::cout << "ERROR: --golden needs the software backend" << std::endl;
+            exitCode = 1;
+        }
+    }
+
+    if (desc.renderBackend == Renderer2D::RENDER_BACKEND_NULL) {
+        PrintRenderStats();
+    }
+
     Application::Shutdown();
 
-    return 0;
+    return exitCode;
 }
\ No newline at end of file